@@ -0,0 +1,219 @@
+#ifndef SCPROG_ALLOCATOR_HH
+#define SCPROG_ALLOCATOR_HH
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "parallel.hh"
+
+namespace scprog
+{
+  /// Thread that first writes the memory of the dense containers, i.e. dense_vector and
+  /// dense_matrix. On NUMA systems a page is placed on the memory node of this thread.
+  enum class first_touch_mode
+  {
+    serial,   ///< the constructing thread initializes all entries
+    parallel  ///< entries are initialized by a static parallel loop, like in the kernels
+  };
+
+  /// Page size backing large buffers (at least 2 MiB) of the dense containers, on Linux only
+  enum class huge_page_mode
+  {
+    none,         ///< default pages, or huge pages if transparent huge pages are set to "always"
+    transparent,  ///< request transparent huge pages by madvise(MADV_HUGEPAGE)
+    hugetlb       ///< pages from the reserved pool (vm.nr_hugepages), else transparent ones
+  };
+
+  namespace impl
+  {
+    // the process-wide first-touch mode, shared by all translation units
+    inline std::atomic<first_touch_mode>& current_first_touch_mode()
+    {
+      static std::atomic<first_touch_mode> mode{first_touch_mode::serial};
+      return mode;
+    }
+
+    // the process-wide huge-page mode, shared by all translation units
+    inline std::atomic<huge_page_mode>& current_huge_page_mode()
+    {
+      static std::atomic<huge_page_mode> mode{huge_page_mode::none};
+      return mode;
+    }
+
+  } // end namespace impl
+
+  /// Set the first-touch mode of all subsequently initialized containers
+  inline void set_first_touch_mode(first_touch_mode mode)
+  {
+    impl::current_first_touch_mode() = mode;
+  }
+
+  /// Return the current first-touch mode
+  inline first_touch_mode get_first_touch_mode()
+  {
+    return impl::current_first_touch_mode();
+  }
+
+  /// Set the huge-page mode of all subsequently allocated large buffers
+  inline void set_huge_page_mode(huge_page_mode mode)
+  {
+    impl::current_huge_page_mode() = mode;
+  }
+
+  /// Return the current huge-page mode
+  inline huge_page_mode get_huge_page_mode()
+  {
+    return impl::current_huge_page_mode();
+  }
+
+
+  /// Allocator of the dense containers. It leaves default-constructed entries uninitialized,
+  /// so the container can first-touch its memory by \ref first_touch_fill, and maps buffers of
+  /// at least `huge_page_size` bytes directly, aligned to and rounded up to huge pages.
+  template <class T>
+  class first_touch_allocator
+  {
+  public:
+    using value_type = T;
+
+    static constexpr std::size_t huge_page_size = std::size_t(1) << 21;
+
+
+  // ----- constructors / assignment -------------------------------------------
+  public:
+
+    first_touch_allocator() = default;
+
+    template <class U>
+    first_touch_allocator(first_touch_allocator<U> const&) noexcept {}
+
+
+  // ----- allocation  ---------------------------------------------------------
+  public:
+
+    /// allocate uninitialized memory for n objects of type T
+    T* allocate(std::size_t n)
+    {
+      std::size_t const bytes = n * sizeof(T);
+#ifdef __linux__
+      if (bytes >= huge_page_size)
+        return static_cast<T*>(map(round_up(bytes)));
+#endif
+      return static_cast<T*>(::operator new(bytes));
+    }
+
+    /// release the memory of n objects obtained from \ref allocate
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+      std::size_t const bytes = n * sizeof(T);
+#ifdef __linux__
+      if (bytes >= huge_page_size) {
+        ::munmap(p, round_up(bytes));
+        return;
+      }
+#endif
+      ::operator delete(p);
+    }
+
+    /// default-initialize the object at p, i.e. leave scalars uninitialized
+    template <class U>
+    void construct(U* p)
+    {
+      ::new(static_cast<void*>(p)) U;
+    }
+
+    /// construct the object at p from the arguments
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args)
+    {
+      ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    friend bool operator==(first_touch_allocator const&, first_touch_allocator const&) { return true; }
+    friend bool operator!=(first_touch_allocator const&, first_touch_allocator const&) { return false; }
+
+
+  private:
+
+    static std::size_t round_up(std::size_t bytes)
+    {
+      return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
+
+#ifdef __linux__
+    // map `length` bytes of anonymous memory, aligned to huge_page_size. No page is touched.
+    static void* map(std::size_t length)
+    {
+      huge_page_mode const mode = get_huge_page_mode();
+#ifdef MAP_HUGETLB
+      if (mode == huge_page_mode::hugetlb) {
+        void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+          return p;
+      }
+#endif
+
+      // over-allocate by one huge page and unmap the unaligned head and tail
+      std::size_t const total = length + huge_page_size;
+      void* q = ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (q == MAP_FAILED)
+        throw std::bad_alloc{};
+      char* const base = static_cast<char*>(q);
+      std::size_t const head = (huge_page_size - reinterpret_cast<std::size_t>(base) % huge_page_size) % huge_page_size;
+      if (head > 0)
+        ::munmap(base, head);
+      if (total - head > length)
+        ::munmap(base + head + length, total - head - length);
+
+#ifdef MADV_HUGEPAGE
+      if (mode != huge_page_mode::none)
+        ::madvise(base + head, length, MADV_HUGEPAGE);
+#endif
+      return base + head;
+    }
+#endif
+  };
+
+
+  /// Write the value v to all entries of the rows x cols array `data`, with the rows
+  /// distributed by the same static schedule as in the row-wise kernels if the first-touch
+  /// mode is parallel. Vectors are filled as an array of n x 1 entries.
+  template <class T>
+  void first_touch_fill(T* data, std::size_t rows, std::size_t cols, T const& v)
+  {
+    bool const parallel = get_first_touch_mode() == first_touch_mode::parallel;
+    (void)parallel;
+    SCPROG_PRAGMA_OMP(parallel for schedule(static) if(parallel))
+    for (std::size_t r = 0; r < rows; ++r) {
+      T* row = data + r * cols;
+      for (std::size_t c = 0; c < cols; ++c)
+        row[c] = v;
+    }
+  }
+
+  /// Copy the rows x cols array `src` to `dst`, with the rows distributed as in
+  /// \ref first_touch_fill if the first-touch mode is parallel
+  template <class T>
+  void first_touch_copy(T* dst, T const* src, std::size_t rows, std::size_t cols)
+  {
+    bool const parallel = get_first_touch_mode() == first_touch_mode::parallel;
+    (void)parallel;
+    SCPROG_PRAGMA_OMP(parallel for schedule(static) if(parallel))
+    for (std::size_t r = 0; r < rows; ++r) {
+      T* row = dst + r * cols;
+      T const* src_row = src + r * cols;
+      for (std::size_t c = 0; c < cols; ++c)
+        row[c] = src_row[c];
+    }
+  }
+
+} // end namespace scprog
+
+#endif // SCPROG_ALLOCATOR_HH
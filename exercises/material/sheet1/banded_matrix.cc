@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "banded_matrix.hh"
+#include "sparse_matrix.hh"
+#include "views.hh"
+
+namespace scprog {
+
+namespace {
+
+  using graph = std::vector<std::vector<std::size_t>>;
+
+  // Extract the symmetric adjacency structure of the nonzero pattern of A (without diagonal)
+  graph adjacency(dense_matrix const& A)
+  {
+    assert(A.rows() == A.cols());
+    graph adj(A.rows());
+    for (std::size_t r = 0; r < A.rows(); ++r) {
+      auto const* row = A[r];
+      for (std::size_t c = 0; c < A.cols(); ++c) {
+        if (r != c && (row[c] != 0.0 || A(c,r) != 0.0))
+          adj[r].push_back(c);
+      }
+    }
+    return adj;
+  }
+
+  // Extract the symmetric adjacency structure of the nonzero pattern of a sparse A (without
+  // diagonal), by merging each row of A with the same row of A^T. Both are sorted by column,
+  // thus the neighbors are sorted and free of duplicates.
+  graph adjacency(sparse_matrix const& A)
+  {
+    assert(A.rows() == A.cols());
+    std::size_t const n = A.rows();
+    auto const& row_ptr = A.row_ptr();
+    auto const& col_idx = A.col_idx();
+    auto const& values = A.values();
+
+    // pattern of A^T by a counting sort of the nonzero entries by column
+    std::vector<std::size_t> t_ptr(n+1, 0);
+    for (std::size_t k = 0; k < row_ptr[n]; ++k)
+      if (values[k] != 0.0)
+        ++t_ptr[col_idx[k] + 1];
+    for (std::size_t c = 0; c < n; ++c)
+      t_ptr[c+1] += t_ptr[c];
+    std::vector<std::size_t> t_idx(t_ptr[n]);
+    std::vector<std::size_t> pos(t_ptr.begin(), t_ptr.end() - 1);
+    for (std::size_t r = 0; r < n; ++r)
+      for (std::size_t k = row_ptr[r]; k < row_ptr[r+1]; ++k)
+        if (values[k] != 0.0)
+          t_idx[pos[col_idx[k]]++] = r;
+
+    graph adj(n);
+    for (std::size_t r = 0; r < n; ++r) {
+      std::size_t k = row_ptr[r], t = t_ptr[r];
+      while (k < row_ptr[r+1] || t < t_ptr[r+1]) {
+        if (k < row_ptr[r+1] && values[k] == 0.0) {
+          ++k;
+          continue;
+        }
+
+        std::size_t c;
+        if (t == t_ptr[r+1] || (k < row_ptr[r+1] && col_idx[k] < t_idx[t]))
+          c = col_idx[k++];
+        else if (k == row_ptr[r+1] || t_idx[t] < col_idx[k])
+          c = t_idx[t++];
+        else {
+          c = col_idx[k++];
+          ++t;
+        }
+
+        if (c != r)
+          adj[r].push_back(c);
+      }
+    }
+    return adj;
+  }
+
+  // Breadth-first search from `root` returning the level structure of the connected component
+  std::vector<std::vector<std::size_t>> level_structure(graph const& adj, std::size_t root,
+                                                        std::vector<char>& mark)
+  {
+    std::vector<std::vector<std::size_t>> levels{{root}};
+    mark[root] = 1;
+    while (true) {
+      std::vector<std::size_t> next;
+      for (std::size_t v : levels.back())
+        for (std::size_t w : adj[v])
+          if (!mark[w]) {
+            mark[w] = 1;
+            next.push_back(w);
+          }
+      if (next.empty())
+        break;
+      levels.push_back(std::move(next));
+    }
+
+    // reset the marks so that the search can be repeated
+    for (auto const& level : levels)
+      for (std::size_t v : level)
+        mark[v] = 0;
+    return levels;
+  }
+
+  // Find a pseudo-peripheral node of the component containing `start` (George-Liu algorithm)
+  std::size_t pseudo_peripheral_node(graph const& adj, std::size_t start, std::vector<char>& mark)
+  {
+    std::size_t root = start;
+    auto levels = level_structure(adj, root, mark);
+    while (true) {
+      // candidate: node of minimal degree in the last level
+      auto const& last = levels.back();
+      std::size_t candidate = *std::min_element(last.begin(), last.end(),
+        [&adj](std::size_t a, std::size_t b) { return adj[a].size() < adj[b].size(); });
+
+      auto candidate_levels = level_structure(adj, candidate, mark);
+      if (candidate_levels.size() <= levels.size())
+        return root;
+
+      root = candidate;
+      levels = std::move(candidate_levels);
+    }
+  }
+
+
+  // Reverse Cuthill-McKee ordering of the graph, component by component
+  std::vector<std::size_t> rcm_ordering(graph adj)
+  {
+    std::size_t const n = adj.size();
+
+    // visit neighbors in order of increasing degree
+    for (auto& neighbors : adj)
+      std::sort(neighbors.begin(), neighbors.end(),
+        [&adj](std::size_t a, std::size_t b) { return adj[a].size() < adj[b].size(); });
+
+    std::vector<std::size_t> perm;
+    perm.reserve(n);
+    std::vector<char> visited(n, 0), mark(n, 0);
+    for (std::size_t start = 0; start < n; ++start) {
+      if (visited[start])
+        continue;
+
+      // Cuthill-McKee ordering of the connected component, starting at a peripheral node
+      std::size_t head = perm.size();
+      std::size_t root = pseudo_peripheral_node(adj, start, mark);
+      perm.push_back(root);
+      visited[root] = 1;
+      for (; head < perm.size(); ++head) {
+        for (std::size_t w : adj[perm[head]]) {
+          if (!visited[w]) {
+            visited[w] = 1;
+            perm.push_back(w);
+          }
+        }
+      }
+    }
+
+    std::reverse(perm.begin(), perm.end());
+    return perm;
+  }
+
+
+  // computes y = A*x for vectors or vector views, using the lower band of row r also as the
+  // upper band of column r
+  template <class VectorX, class VectorY>
+  void banded_mult(banded_matrix const& A, VectorX const& x, VectorY& y)
+  {
+    using size_type  = typename banded_matrix::size_type;
+    using value_type = typename banded_matrix::value_type;
+    assert(x.size() == A.cols());
+    assert(y.size() == A.rows());
+    size_type const k = A.bandwidth();
+    for (size_type r = 0; r < A.rows(); ++r) {
+      value_type const* row = A[r];
+      size_type const c0 = r > k ? r - k : 0;
+
+      // the lower band of row r and, by symmetry, the upper band of column r
+      value_type y_r = row[k] * x[r];
+      for (size_type c = c0; c < r; ++c) {
+        y_r += row[k + c - r] * x[c];
+        y[c] += row[k + c - r] * x[r];
+      }
+      y[r] = y_r;
+    }
+  }
+
+} // end anonymous namespace
+
+
+// construct the lower band of P*A*P^T from a dense symmetric matrix
+banded_matrix::banded_matrix(dense_matrix const& A, std::vector<size_type> const& perm)
+  : rows_(A.rows())
+{
+  assert(A.rows() == A.cols());
+  assert(perm.empty() || perm.size() == A.rows());
+
+  // inverse permutation: old index -> new index
+  std::vector<size_type> inv(rows_);
+  for (size_type i = 0; i < rows_; ++i)
+    inv[perm.empty() ? i : perm[i]] = i;
+
+  // 1. determine the bandwidth from the nonzero pattern
+  for (size_type r = 0; r < rows_; ++r) {
+    value_type const* row = A[r];
+    for (size_type c = 0; c < rows_; ++c) {
+      if (row[c] != value_type(0))
+        bandwidth_ = std::max(bandwidth_, inv[r] < inv[c] ? inv[c] - inv[r] : inv[r] - inv[c]);
+    }
+  }
+
+  // 2. copy the lower band entries into the band storage
+  data_.assign(rows_*(bandwidth_+1), value_type(0));
+  for (size_type r = 0; r < rows_; ++r) {
+    value_type const* row = A[r];
+    for (size_type c = 0; c < rows_; ++c) {
+      if (inv[c] <= inv[r] && row[c] != value_type(0))
+        (*this)(inv[r], inv[c]) = row[c];
+    }
+  }
+}
+
+
+// construct the lower band of P*A*P^T from a sparse symmetric matrix
+banded_matrix::banded_matrix(sparse_matrix const& A, std::vector<size_type> const& perm)
+  : rows_(A.rows())
+{
+  assert(A.rows() == A.cols());
+  assert(perm.empty() || perm.size() == A.rows());
+  auto const& row_ptr = A.row_ptr();
+  auto const& col_idx = A.col_idx();
+  auto const& values = A.values();
+
+  // inverse permutation: old index -> new index
+  std::vector<size_type> inv(rows_);
+  for (size_type i = 0; i < rows_; ++i)
+    inv[perm.empty() ? i : perm[i]] = i;
+
+  // 1. determine the bandwidth from the nonzero pattern
+  for (size_type r = 0; r < rows_; ++r) {
+    for (size_type k = row_ptr[r]; k < row_ptr[r+1]; ++k) {
+      size_type const c = col_idx[k];
+      if (values[k] != value_type(0))
+        bandwidth_ = std::max(bandwidth_, inv[r] < inv[c] ? inv[c] - inv[r] : inv[r] - inv[c]);
+    }
+  }
+
+  // 2. copy the lower band entries into the band storage
+  data_.assign(rows_*(bandwidth_+1), value_type(0));
+  for (size_type r = 0; r < rows_; ++r) {
+    for (size_type k = row_ptr[r]; k < row_ptr[r+1]; ++k) {
+      size_type const c = col_idx[k];
+      if (inv[c] <= inv[r] && values[k] != value_type(0))
+        (*this)(inv[r], inv[c]) = values[k];
+    }
+  }
+}
+
+
+// set all band entries to v
+banded_matrix& banded_matrix::operator=(value_type v)
+{
+  for (auto& A_ij : data_)
+    A_ij = v;
+  return *this;
+}
+
+
+// matrix-vector product A*x
+dense_vector operator*(banded_matrix const& A, dense_vector const& x)
+{
+  using value_type = typename banded_matrix::value_type;
+  dense_vector y(A.rows(), value_type(0));
+  A.mult(x, y);
+  return y;
+}
+
+
+// computes the matrix-vector product, y = Ax.
+void banded_matrix::mult(dense_vector const& x, dense_vector& y) const
+{
+  banded_mult(*this, x, y);
+}
+
+
+// computes the matrix-vector product, y = Ax, for vector views
+void banded_matrix::mult(const_vector_view const& x, vector_view const& y) const
+{
+  banded_mult(*this, x, y);
+}
+
+
+// Setup a banded matrix according to a Laplacian equation on a 2D-grid using a five-point-stencil.
+// Results in a matrix A of size (m*n) x (m*n) with bandwidth n
+void laplacian_setup(banded_matrix& A, std::size_t m, std::size_t n)
+{
+  A.resize(m*n, n);
+  A = 0;
+
+  for (std::size_t i = 0; i < m; i++) {
+    for (std::size_t j = 0; j < n; j++) {
+      std::size_t row = i * n + j;
+      A(row, row) = 4;
+      if (j > 0) A(row, row - 1) = -1;
+      if (i > 0) A(row, row - n) = -1;
+    }
+  }
+}
+
+
+// Compute the Cholesky factorization A = L*L^T in-place
+void cholesky_factor(banded_matrix& A)
+{
+  using std::sqrt;
+  using size_type  = typename banded_matrix::size_type;
+  using value_type = typename banded_matrix::value_type;
+
+  size_type const k = A.bandwidth();
+  for (size_type i = 0; i < A.rows(); ++i) {
+    value_type* L_i = A[i];
+    size_type const p0 = i > k ? i - k : 0;
+
+    // L(i,j) = (A(i,j) - sum_{p<j} L(i,p)*L(j,p)) / L(j,j), both rows are stored contiguously
+    for (size_type j = p0; j <= i; ++j) {
+      value_type const* L_j = A[j];
+      value_type s = L_i[k + j - i];
+      for (size_type p = p0; p < j; ++p)
+        s -= L_i[k + p - i] * L_j[k + p - j];
+
+      if (j < i)
+        L_i[k + j - i] = s / L_j[k];
+      else if (s > value_type(0))
+        L_i[k] = sqrt(s);
+      else
+        throw std::domain_error("cholesky_factor: matrix is not positive definite");
+    }
+  }
+}
+
+
+// Solve the linear system L*L^T*x = b
+void cholesky_solve(banded_matrix const& L, dense_vector& x, dense_vector const& b)
+{
+  using size_type  = typename banded_matrix::size_type;
+  using value_type = typename banded_matrix::value_type;
+
+  assert(b.size() == L.rows());
+  assert(x.size() == L.rows());
+  size_type const n = L.rows();
+  size_type const k = L.bandwidth();
+
+  // forward substitution L*y = b, with y stored in x
+  for (size_type i = 0; i < n; ++i) {
+    value_type const* L_i = L[i];
+    value_type s = b[i];
+    for (size_type p = (i > k ? i - k : 0); p < i; ++p)
+      s -= L_i[k + p - i] * x[p];
+    x[i] = s / L_i[k];
+  }
+
+  // backward substitution L^T*x = y, column-oriented to traverse the rows of L
+  for (size_type i = n; i-- > 0;) {
+    value_type const* L_i = L[i];
+    x[i] /= L_i[k];
+    for (size_type p = (i > k ? i - k : 0); p < i; ++p)
+      x[p] -= L_i[k + p - i] * x[i];
+  }
+}
+
+
+// Compute a bandwidth reducing permutation by the reverse Cuthill-McKee algorithm
+std::vector<std::size_t> reverse_cuthill_mckee(dense_matrix const& A)
+{
+  return rcm_ordering(adjacency(A));
+}
+
+
+// Compute the reverse Cuthill-McKee permutation of a sparse matrix
+std::vector<std::size_t> reverse_cuthill_mckee(sparse_matrix const& A)
+{
+  return rcm_ordering(adjacency(A));
+}
+
+
+// Apply the permutation to a vector, y[i] = x[perm[i]]
+void permute(std::vector<std::size_t> const& perm, dense_vector const& x, dense_vector& y)
+{
+  assert(perm.size() == x.size());
+  assert(y.size() == x.size());
+  for (std::size_t i = 0; i < perm.size(); ++i)
+    y[i] = x[perm[i]];
+}
+
+
+// Apply the inverse permutation to a vector, y[perm[i]] = x[i]
+void permute_back(std::vector<std::size_t> const& perm, dense_vector const& x, dense_vector& y)
+{
+  assert(perm.size() == x.size());
+  assert(y.size() == x.size());
+  for (std::size_t i = 0; i < perm.size(); ++i)
+    y[perm[i]] = x[i];
+}
+
+} // end namespace scprog
@@ -0,0 +1,172 @@
+#ifndef SCPROG_BANDED_MATRIX_HH
+#define SCPROG_BANDED_MATRIX_HH
+
+#include <cassert>
+#include <vector>
+
+#include "linear_algebra.hh"
+
+namespace scprog
+{
+  // compressed row storage, see sparse_matrix.hh
+  class sparse_matrix;
+
+  /// A symmetric banded matrix storing only the lower band, i.e. the entries A(r,c) with
+  /// r-k <= c <= r for bandwidth k. Row r is stored contiguously in (k+1) entries with the
+  /// diagonal at the last position, resulting in a storage footprint of N*(k+1).
+  class banded_matrix
+  {
+  public:
+    using size_type       = std::size_t;
+    using value_type      = double;
+    using reference       = value_type&;
+    using const_reference = value_type const&;
+    using pointer         = value_type*;
+    using const_pointer   = value_type const*;
+
+
+  // ----- constructors / assignment -------------------------------------------
+  public:
+
+    /// default constructor, creates an empty matrix of size 0x0
+    banded_matrix() = default;
+
+    /// constructor of a matrix of size n x n with bandwidth k and all band entries initialized with value v
+    explicit banded_matrix(size_type n, size_type k, value_type v = value_type{})
+      : data_(n*(k+1), v)
+      , rows_(n)
+      , bandwidth_(k)
+    {}
+
+    /// constructor extracting the lower band of the symmetric matrix P*A*P^T, with P given
+    /// by the permutation `perm` (new index -> old index). The bandwidth is determined from
+    /// the nonzero pattern of A. An empty permutation means the identity.
+    explicit banded_matrix(dense_matrix const& A, std::vector<size_type> const& perm = {});
+
+    /// constructor extracting the lower band of P*A*P^T from a sparse symmetric matrix, with
+    /// cost O(nnz) besides the band storage
+    explicit banded_matrix(sparse_matrix const& A, std::vector<size_type> const& perm = {});
+
+    /// set all band entries to v
+    banded_matrix& operator=(value_type v);
+
+    /// resize matrix to size n x n with bandwidth k and fill new entries with value v
+    void resize(size_type n, size_type k, value_type v = value_type{})
+    {
+      data_.resize(n*(k+1), v);
+      rows_ = n;
+      bandwidth_ = k;
+    }
+
+    /// return the number of rows in the matrix
+    size_type rows() const
+    {
+      return rows_;
+    }
+
+    /// return the number of columns in the matrix
+    size_type cols() const
+    {
+      return rows_;
+    }
+
+    /// return the bandwidth k, i.e. A(r,c) = 0 for |r-c| > k
+    size_type bandwidth() const
+    {
+      return bandwidth_;
+    }
+
+    /// return whether the (r,c)-th entry lies within the stored band
+    bool in_band(size_type r, size_type c) const
+    {
+      return (r < c ? c - r : r - c) <= bandwidth_;
+    }
+
+
+  // ----- element access functions  -------------------------------------------
+  public:
+
+    /// access to the band of the r-th row, i.e. the entries A(r,r-k),...,A(r,r).
+    /// Entries with negative column index are padding and are kept zero.
+    pointer operator[](size_type r)
+    {
+      assert(r < rows_);
+      return data_.data() + (bandwidth_+1) * r;
+    }
+
+    /// access to the band of the r-th row for constant matrices
+    const_pointer operator[](size_type r) const
+    {
+      assert(r < rows_);
+      return data_.data() + (bandwidth_+1) * r;
+    }
+
+    /// access to the (r,c)-th matrix element, with (r,c) and (c,r) referring to the same entry
+    reference operator()(size_type r, size_type c)
+    {
+      assert(in_band(r,c));
+      return r < c ? (*this)[c][bandwidth_ + r - c] : (*this)[r][bandwidth_ + c - r];
+    }
+
+    /// access to the (r,c)-th matrix element (const variant)
+    const_reference operator()(size_type r, size_type c) const
+    {
+      assert(in_band(r,c));
+      return r < c ? (*this)[c][bandwidth_ + r - c] : (*this)[r][bandwidth_ + c - r];
+    }
+
+
+  // ----- binary operations  ---------------------------------------------------
+  public:
+
+    /// matrix vector product A*x
+    friend dense_vector operator*(banded_matrix const& A, dense_vector const& x);
+
+    /// computes the matrix-vector product, y = Ax.
+    void mult(dense_vector const& x, dense_vector& y) const;
+
+    /// computes the matrix-vector product, y = Ax, for views on vector entries (see views.hh),
+    /// e.g. parts of larger vectors. x and y must not overlap.
+    void mult(basic_vector_view<value_type const> const& x, basic_vector_view<value_type> const& y) const;
+
+
+  // ----- data members  -------------------------------------------------------
+  private:
+
+    std::vector<value_type> data_;
+    size_type rows_ = 0;
+    size_type bandwidth_ = 0;
+  };
+
+
+  /// Setup a banded matrix according to a Laplacian equation on a 2D-grid using a five-point-stencil.
+  /// Results in a matrix A of size (m*n) x (m*n) with bandwidth n
+  void laplacian_setup(banded_matrix& A, std::size_t m, std::size_t n);
+
+
+  /// Compute the Cholesky factorization A = L*L^T in-place, overwriting the lower band of A by L.
+  /// The factor has the same bandwidth as A, thus the cost is O(N*k^2).
+  /// Throws std::domain_error if A is not positive definite.
+  void cholesky_factor(banded_matrix& A);
+
+  /// Solve the linear system L*L^T*x = b with the factor L computed by \ref cholesky_factor
+  void cholesky_solve(banded_matrix const& L, dense_vector& x, dense_vector const& b);
+
+
+  /// Compute a bandwidth reducing permutation of the symmetric nonzero pattern of A by the
+  /// reverse Cuthill-McKee algorithm. Returns the vector perm with perm[new index] = old index.
+  std::vector<std::size_t> reverse_cuthill_mckee(dense_matrix const& A);
+
+  /// Compute the reverse Cuthill-McKee permutation of a sparse matrix, with the graph built
+  /// from the pattern of A + A^T in O(nnz)
+  std::vector<std::size_t> reverse_cuthill_mckee(sparse_matrix const& A);
+
+  /// Apply the permutation to a vector, y[i] = x[perm[i]]
+  void permute(std::vector<std::size_t> const& perm, dense_vector const& x, dense_vector& y);
+
+  /// Apply the inverse permutation to a vector, y[perm[i]] = x[i]
+  void permute_back(std::vector<std::size_t> const& perm, dense_vector const& x, dense_vector& y);
+
+} // end namespace scprog
+
+#endif // SCPROG_BANDED_MATRIX_HH
@@ -0,0 +1,78 @@
+#include <limits>
+
+#include "chebyshev.hh"
+
+namespace scprog {
+
+// record the CG step size alpha_k and the coefficient beta_{k-1}
+void lanczos_estimator::add_step(value_type alpha, value_type beta)
+{
+  using std::sqrt;
+  assert(alpha > value_type(0));
+  if (diag_.empty())
+    diag_.push_back(1 / alpha);
+  else {
+    diag_.push_back(1 / alpha + beta / last_alpha_);
+    offdiag_.push_back(sqrt(beta) / last_alpha_);
+  }
+  last_alpha_ = alpha;
+}
+
+
+// number of eigenvalues of T smaller than x, by the Sturm sequence of T - x*I
+typename lanczos_estimator::size_type lanczos_estimator::count_below(value_type x) const
+{
+  size_type count = 0;
+  value_type d = 1;
+  for (size_type k = 0; k < diag_.size(); ++k) {
+    value_type const e2 = k > 0 ? offdiag_[k-1] * offdiag_[k-1] : value_type(0);
+    d = diag_[k] - x - e2 / d;
+    if (d == value_type(0))
+      d = std::numeric_limits<value_type>::epsilon() * (std::abs(x) + e2 + 1);
+    if (d < value_type(0))
+      ++count;
+  }
+  return count;
+}
+
+
+// return the k-th smallest eigenvalue of T, by bisection in the Gershgorin interval
+typename lanczos_estimator::value_type lanczos_estimator::eigenvalue(size_type k) const
+{
+  using std::abs;
+  if (diag_.empty())
+    throw std::domain_error("lanczos_estimator: no CG step recorded");
+  assert(1 <= k && k <= diag_.size());
+  value_type lo = diag_[0], hi = diag_[0];
+  for (size_type i = 0; i < diag_.size(); ++i) {
+    value_type const radius = (i > 0 ? abs(offdiag_[i-1]) : 0) + (i < offdiag_.size() ? abs(offdiag_[i]) : 0);
+    lo = std::min(lo, diag_[i] - radius);
+    hi = std::max(hi, diag_[i] + radius);
+  }
+
+  // the k-th eigenvalue is the smallest x with count_below(x) >= k
+  for (int i = 0; i < 100 && hi - lo > 1.e-14 * (abs(lo) + abs(hi)); ++i) {
+    value_type const mid = (lo + hi) / 2;
+    if (count_below(mid) >= k)
+      hi = mid;
+    else
+      lo = mid;
+  }
+  return (lo + hi) / 2;
+}
+
+
+// return the smallest eigenvalue of T
+typename lanczos_estimator::value_type lanczos_estimator::min_eigenvalue() const
+{
+  return eigenvalue(1);
+}
+
+
+// return the largest eigenvalue of T
+typename lanczos_estimator::value_type lanczos_estimator::max_eigenvalue() const
+{
+  return eigenvalue(diag_.size());
+}
+
+} // end namespace scprog
@@ -0,0 +1,190 @@
+#ifndef SCPROG_CHEBYSHEV_HH
+#define SCPROG_CHEBYSHEV_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "linear_algebra.hh"
+
+namespace scprog
+{
+  /// Estimator of the extremal eigenvalues of a symmetric positive definite matrix A from the
+  /// coefficients of a CG run. By the Lanczos connection, the CG coefficients alpha_k and
+  /// beta_k = rho_{k+1}/rho_k define the tridiagonal matrix T with
+  ///   T_kk = 1/alpha_k + beta_{k-1}/alpha_{k-1},   T_{k,k+1} = sqrt(beta_k)/alpha_k,
+  /// whose eigenvalues (Ritz values) approximate the spectrum of A from the inside.
+  class lanczos_estimator
+  {
+  public:
+    using size_type  = std::size_t;
+    using value_type = double;
+
+
+  // ----- constructors / assignment -------------------------------------------
+  public:
+
+    /// default constructor, creates an estimator without any recorded step
+    lanczos_estimator() = default;
+
+    /// record the CG step size alpha_k and the coefficient beta_{k-1} = rho_k/rho_{k-1} used
+    /// for the search direction of step k (ignored for k = 0)
+    void add_step(value_type alpha, value_type beta);
+
+    /// record a CG step, such that the estimator can be passed as observer to \ref cg
+    void operator()(value_type alpha, value_type beta)
+    {
+      add_step(alpha, beta);
+    }
+
+    /// remove all recorded steps
+    void clear()
+    {
+      diag_.clear();
+      offdiag_.clear();
+    }
+
+    /// return the number of recorded steps, i.e. the size of T
+    size_type size() const
+    {
+      return diag_.size();
+    }
+
+
+  // ----- eigenvalue estimates  -----------------------------------------------
+  public:
+
+    /// return the smallest eigenvalue of T, an upper bound for the smallest eigenvalue of A.
+    /// Throws std::domain_error if no step is recorded, as for \ref eigenvalue.
+    value_type min_eigenvalue() const;
+
+    /// return the largest eigenvalue of T, a lower bound for the largest eigenvalue of A.
+    /// Chebyshev iteration diverges for an underestimated spectrum, so enlarge this value
+    /// by a safety margin, e.g. 10%. Throws std::domain_error if no step is recorded.
+    value_type max_eigenvalue() const;
+
+    /// return the k-th smallest eigenvalue of T, k = 1,...,size(). Throws std::domain_error
+    /// if no step is recorded, e.g. for b = 0 or if CG converged before its first iteration.
+    value_type eigenvalue(size_type k) const;
+
+
+  private:
+
+    // number of eigenvalues of T smaller than x, by the Sturm sequence of T - x*I
+    size_type count_below(value_type x) const;
+
+
+  // ----- data members  -------------------------------------------------------
+  private:
+
+    std::vector<value_type> diag_;
+    std::vector<value_type> offdiag_;
+    value_type last_alpha_ = 0;
+  };
+
+
+  /// Estimate the spectrum of the symmetric positive definite matrix A by a short CG run of
+  /// at most `steps` iterations for the system A*x = b, starting from x = 0. The estimator
+  /// is empty if b = 0, so use a generic, e.g. random, vector b.
+  template <class Matrix>
+  lanczos_estimator estimate_eigenvalues(Matrix const& A, dense_vector const& b, int steps = 10)
+  {
+    lanczos_estimator lanczos;
+    dense_vector x(b.size(), 0.0);
+    iteration iter(b, steps, 0.0);
+    iter.set_quite(true);
+    iter.suppress_resume(true);
+    cg(A, x, b, iter, lanczos);
+    return lanczos;
+  }
+
+
+  namespace impl
+  {
+    // Perform `steps` iterations of the Chebyshev recurrence for the spectrum in [lmin, lmax],
+    // updating the solution x, the residual r and the update direction d, using q as temporary.
+    // The state rho = 0 starts a new recurrence, otherwise the previous one is continued.
+    template <class Matrix>
+    void chebyshev_steps(Matrix const& A, dense_vector& x, dense_vector& r, dense_vector& d,
+                         dense_vector& q, double lmin, double lmax, double& rho, int steps)
+    {
+      assert(0 < lmin && lmin < lmax);
+      double const theta = (lmax + lmin) / 2;
+      double const delta = (lmax - lmin) / 2;
+      double const sigma = theta / delta;
+
+      for (int k = 0; k < steps; ++k) {
+        if (rho == 0.0) {
+          d = r;
+          d *= 1.0 / theta;               // d = r / theta
+          rho = 1.0 / sigma;
+        } else {
+          double const rho_new = 1.0 / (2*sigma - rho);
+          d *= rho_new * rho;
+          d.axpy(2*rho_new / delta, r);   // d = rho_new*rho * d + 2*rho_new/delta * r
+          rho = rho_new;
+        }
+
+        x += d;
+        A.mult(d, q);
+        r -= q;                           // r = b - A*x
+      }
+    }
+
+  } // end namespace impl
+
+
+  /// Apply the Chebyshev iteration to the linear system A*x = b with the spectrum of A
+  /// contained in [lmin, lmax], and return an error code. The iteration needs no inner
+  /// products, the residual norm is only evaluated every `check` iterations.
+  /**
+   * \param A      The symmetric positive definite system matrix, providing A.mult(x,y)
+   * \param x      The solution vector. Must be of correct size.
+   * \param b      The load vector of the linear system
+   * \param iter   An iteration object controlling number of iterations and break tolerances.
+   * \param lmin   Lower bound of the spectrum of A
+   * \param lmax   Upper bound of the spectrum of A
+   * \param check  Number of iterations between two residual checks
+   *
+   * \return The error code of the \ref iteration object. err=0 means no error.
+   **/
+  template <class Matrix>
+  int chebyshev(Matrix const& A, dense_vector& x, dense_vector const& b, iteration& iter,
+                double lmin, double lmax, int check = 10)
+  {
+    assert(check > 0);
+    dense_vector r(b.size()), d(b.size()), q(b.size());
+    A.mult(x, r);
+    r.aypx(-1, b);          // r = b - A*x
+
+    double rho = 0;
+    while (! iter.finished(r)) {
+      int const steps = std::min(check, iter.max_iterations() - iter.iterations());
+      impl::chebyshev_steps(A, x, r, d, q, lmin, lmax, rho, steps);
+      iter += steps;
+    }
+
+    return iter;
+  }
+
+
+  /// Apply `steps` iterations of the Chebyshev iteration to A*x = b without any convergence
+  /// check, e.g. as smoother for the spectrum part [lmin, lmax], or with x = 0 as polynomial
+  /// preconditioner x = p(A)*b approximating A^{-1}*b.
+  template <class Matrix>
+  void chebyshev_smooth(Matrix const& A, dense_vector& x, dense_vector const& b,
+                        double lmin, double lmax, int steps)
+  {
+    dense_vector r(b.size()), d(b.size()), q(b.size());
+    A.mult(x, r);
+    r.aypx(-1, b);          // r = b - A*x
+
+    double rho = 0;
+    impl::chebyshev_steps(A, x, r, d, q, lmin, lmax, rho, steps);
+  }
+
+} // end namespace scprog
+
+#endif // SCPROG_CHEBYSHEV_HH
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+#include "fft.hh"
+
+namespace scprog {
+
+namespace {
+
+  bool is_power_of_two(std::size_t n)
+  {
+    return n > 0 && (n & (n - 1)) == 0;
+  }
+
+} // end anonymous namespace
+
+
+// constructor of a plan for transforms of length n
+fft_plan::fft_plan(size_type n)
+  : n_(n)
+{
+  using std::cos;
+  using std::sin;
+  assert(n > 0);
+  real_type const pi = std::acos(real_type(-1));
+
+  if (is_power_of_two(n)) {
+    twiddle_.resize(n / 2);
+    for (size_type k = 0; k < n / 2; ++k)
+      twiddle_[k] = complex_type(cos(2*pi*k/n), -sin(2*pi*k/n));
+
+    size_type log_n = 0;
+    while ((size_type(1) << log_n) < n)
+      ++log_n;
+    bitrev_.resize(n);
+    for (size_type i = 0; i < n; ++i) {
+      size_type r = 0;
+      for (size_type b = 0; b < log_n; ++b)
+        r |= ((i >> b) & 1) << (log_n - 1 - b);
+      bitrev_[i] = r;
+    }
+  }
+  else {
+    // chirp w_k = exp(-pi*i*k^2/n), with k^2 reduced modulo 2n to keep the angle accurate
+    chirp_.resize(n);
+    for (size_type k = 0; k < n; ++k) {
+      real_type angle = pi * real_type((k*k) % (2*n)) / n;
+      chirp_[k] = complex_type(cos(angle), -sin(angle));
+    }
+
+    size_type m = 1;
+    while (m < 2*n - 1)
+      m <<= 1;
+    inner_.reset(new fft_plan(m));
+
+    // circulant filter conj(w_k) for k = -(n-1),...,n-1, wrapped to length m
+    chirp_hat_.assign(m, complex_type(0));
+    chirp_hat_[0] = std::conj(chirp_[0]);
+    for (size_type k = 1; k < n; ++k)
+      chirp_hat_[k] = chirp_hat_[m - k] = std::conj(chirp_[k]);
+    inner_->radix2(chirp_hat_.data());
+  }
+}
+
+
+// in-place forward transform of x
+void fft_plan::forward(std::vector<complex_type>& x) const
+{
+  std::vector<complex_type> work;
+  forward(x, work);
+}
+
+
+// in-place forward transform of x, using the scratch buffer work
+void fft_plan::forward(std::vector<complex_type>& x, std::vector<complex_type>& work) const
+{
+  assert(x.size() == n_);
+  if (inner_)
+    bluestein(x, work);
+  else
+    radix2(x.data());
+}
+
+
+// in-place inverse transform of x, including the scaling by 1/n
+void fft_plan::inverse(std::vector<complex_type>& x) const
+{
+  std::vector<complex_type> work;
+  inverse(x, work);
+}
+
+
+// in-place inverse transform of x, using the scratch buffer work
+void fft_plan::inverse(std::vector<complex_type>& x, std::vector<complex_type>& work) const
+{
+  // ifft(x) = conj(fft(conj(x))) / n
+  for (auto& x_i : x)
+    x_i = std::conj(x_i);
+  forward(x, work);
+  real_type const scale = real_type(1) / n_;
+  for (auto& x_i : x)
+    x_i = std::conj(x_i) * scale;
+}
+
+
+// radix-2 transform of the power-of-two length n_
+void fft_plan::radix2(complex_type* x) const
+{
+  for (size_type i = 0; i < n_; ++i) {
+    if (i < bitrev_[i])
+      std::swap(x[i], x[bitrev_[i]]);
+  }
+
+  for (size_type len = 2; len <= n_; len <<= 1) {
+    size_type const half = len / 2;
+    size_type const stride = n_ / len;
+    for (size_type start = 0; start < n_; start += len) {
+      for (size_type k = 0; k < half; ++k) {
+        complex_type const t = twiddle_[k * stride] * x[start + k + half];
+        x[start + k + half] = x[start + k] - t;
+        x[start + k] += t;
+      }
+    }
+  }
+}
+
+
+// Bluestein transform for arbitrary length n_
+void fft_plan::bluestein(std::vector<complex_type>& x, std::vector<complex_type>& work) const
+{
+  size_type const m = inner_->size();
+  if (work.size() < m)
+    work.resize(m);
+
+  // X_k = w_k * sum_j (x_j * w_j) * conj(w_{k-j}), evaluated as circular convolution of length m
+  complex_type* a = work.data();
+  for (size_type j = 0; j < n_; ++j)
+    a[j] = x[j] * chirp_[j];
+  std::fill(a + n_, a + m, complex_type(0));
+
+  inner_->radix2(a);
+  for (size_type k = 0; k < m; ++k)
+    a[k] = std::conj(a[k] * chirp_hat_[k]);
+  inner_->radix2(a);
+
+  real_type const scale = real_type(1) / m;
+  for (size_type k = 0; k < n_; ++k)
+    x[k] = chirp_[k] * std::conj(a[k]) * scale;
+}
+
+} // end namespace scprog
@@ -0,0 +1,85 @@
+#ifndef SCPROG_FFT_HH
+#define SCPROG_FFT_HH
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace scprog
+{
+  /// A precomputed plan for the discrete Fourier transform of fixed length n,
+  ///   X_k = sum_j x_j exp(-2*pi*i*j*k/n).
+  /// Powers of two are transformed by an iterative radix-2 algorithm with tabulated twiddle
+  /// factors and bit-reversal permutation. All other lengths are reduced to a power-of-two
+  /// convolution by Bluestein's algorithm, with the transformed chirp kept in the plan.
+  class fft_plan
+  {
+  public:
+    using size_type    = std::size_t;
+    using real_type    = double;
+    using complex_type = std::complex<real_type>;
+
+
+  // ----- constructors / assignment -------------------------------------------
+  public:
+
+    /// constructor of a plan for transforms of length n
+    explicit fft_plan(size_type n);
+
+    /// return the transform length
+    size_type size() const
+    {
+      return n_;
+    }
+
+    /// return the size of the scratch buffer needed by the transforms, zero for powers of two
+    size_type work_size() const
+    {
+      return inner_ ? inner_->size() : 0;
+    }
+
+
+  // ----- transforms  ---------------------------------------------------------
+  public:
+
+    /// in-place forward transform of x, with x.size() == size()
+    void forward(std::vector<complex_type>& x) const;
+
+    /// in-place forward transform of x, using the caller-owned scratch buffer work, which is
+    /// enlarged to \ref work_size() if necessary. Reuse work over repeated transforms.
+    void forward(std::vector<complex_type>& x, std::vector<complex_type>& work) const;
+
+    /// in-place inverse transform of x, including the scaling by 1/n
+    void inverse(std::vector<complex_type>& x) const;
+
+    /// in-place inverse transform of x, using the caller-owned scratch buffer work
+    void inverse(std::vector<complex_type>& x, std::vector<complex_type>& work) const;
+
+
+  private:
+
+    // radix-2 transform of the power-of-two length n_
+    void radix2(complex_type* x) const;
+
+    // Bluestein transform for arbitrary length n_
+    void bluestein(std::vector<complex_type>& x, std::vector<complex_type>& work) const;
+
+
+  // ----- data members  -------------------------------------------------------
+  private:
+
+    size_type n_;
+
+    // radix-2: twiddle factors exp(-2*pi*i*k/n), k < n/2, and bit-reversal table
+    std::vector<complex_type> twiddle_;
+    std::vector<size_type> bitrev_;
+
+    // Bluestein: chirp exp(-pi*i*k^2/n), transformed conjugate chirp and inner radix-2 plan
+    std::vector<complex_type> chirp_;
+    std::vector<complex_type> chirp_hat_;
+    std::unique_ptr<fft_plan> inner_;
+  };
+
+} // end namespace scprog
+
+#endif // SCPROG_FFT_HH
@@ -0,0 +1,118 @@
+#include <cmath>
+
+#include "krylov.hh"
+#include "parallel.hh"
+#include "reduction.hh"
+
+namespace scprog {
+
+namespace {
+
+  // number of rows processed together in the block operations, such that the block of w and
+  // all basis blocks touched for it stay in cache
+  constexpr std::size_t block_size = 512;
+
+  // number of row blocks of vectors of size n
+  std::size_t num_blocks(std::size_t n)
+  {
+    return (n + block_size - 1) / block_size;
+  }
+
+} // end anonymous namespace
+
+
+// prepare the workspace for vectors of size n and a Krylov basis of dimension restart+1
+void krylov_workspace::resize(size_type n, size_type restart)
+{
+  size_ = n;
+  restart_ = restart;
+
+  vectors_.resize(num_vectors);
+  for (auto& v : vectors_)
+    v.resize(n);
+
+  if (restart > 0) {
+    basis_.resize((restart+1) * n);
+    hessenberg_.resize((restart+1) * restart);
+    cs_.resize(restart);
+    sn_.resize(restart);
+    g_.resize(restart+1);
+    coeffs_.resize(restart+1);
+    partials_.resize(num_blocks(n) * (restart+1));
+  }
+}
+
+
+// orthogonalize w against the first k basis vectors by classical Gram-Schmidt with re-orthogonalization
+typename krylov_workspace::value_type
+krylov_workspace::orthogonalize(size_type k, value_type* w, value_type* h)
+{
+  using std::sqrt;
+  assert(k <= restart_ + 1);
+
+  size_type const nb = num_blocks(size_);
+  size_type const stride = restart_ + 1;
+  value_type* c = coeffs_.data();
+  value_type* partial = partials_.data();
+  for (size_type i = 0; i < k; ++i)
+    h[i] = value_type(0);
+
+  for (int pass = 0; pass < 2; ++pass) {
+    // c = V^T w, with the partial sums of each row block combined in block order below, so
+    // that the result does not depend on the number of threads
+    SCPROG_PRAGMA_OMP(parallel for schedule(static))
+    for (size_type b = 0; b < nb; ++b) {
+      size_type const r0 = b * block_size;
+      size_type const r1 = std::min(r0 + block_size, size_);
+      for (size_type i = 0; i < k; ++i) {
+        value_type const* v = basis(i);
+        value_type c_i = 0;
+        for (size_type r = r0; r < r1; ++r)
+          c_i += v[r] * w[r];
+        partial[b * stride + i] = c_i;
+      }
+    }
+    for (size_type i = 0; i < k; ++i) {
+      c[i] = value_type(0);
+      for (size_type b = 0; b < nb; ++b)
+        c[i] += partial[b * stride + i];
+    }
+
+    // w -= V c
+    SCPROG_PRAGMA_OMP(parallel for schedule(static))
+    for (size_type b = 0; b < nb; ++b) {
+      size_type const r0 = b * block_size;
+      size_type const r1 = std::min(r0 + block_size, size_);
+      for (size_type i = 0; i < k; ++i) {
+        value_type const* v = basis(i);
+        for (size_type r = r0; r < r1; ++r)
+          w[r] -= c[i] * v[r];
+      }
+    }
+
+    for (size_type i = 0; i < k; ++i)
+      h[i] += c[i];
+  }
+
+  return sqrt(reduce_sum(size_, [w](size_type r) { return w[r] * w[r]; }));
+}
+
+
+// computes x += V y with the first k basis vectors
+void krylov_workspace::basis_mult_add(size_type k, value_type const* y, value_type* x) const
+{
+  assert(k <= restart_ + 1);
+  size_type const nb = num_blocks(size_);
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
+  for (size_type b = 0; b < nb; ++b) {
+    size_type const r0 = b * block_size;
+    size_type const r1 = std::min(r0 + block_size, size_);
+    for (size_type i = 0; i < k; ++i) {
+      value_type const* v = basis(i);
+      for (size_type r = r0; r < r1; ++r)
+        x[r] += y[i] * v[r];
+    }
+  }
+}
+
+} // end namespace scprog
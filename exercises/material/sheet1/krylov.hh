@@ -0,0 +1,311 @@
+#ifndef SCPROG_KRYLOV_HH
+#define SCPROG_KRYLOV_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "linear_algebra.hh"
+#include "views.hh"
+
+namespace scprog
+{
+  /// Preallocated memory for the Krylov solvers \ref bicgstab and \ref gmres, to be reused over
+  /// several solves of the same size. The Krylov basis of GMRES is stored contiguously, with
+  /// each basis vector in consecutive memory, and orthogonalized block-wise.
+  class krylov_workspace
+  {
+  public:
+    using size_type  = std::size_t;
+    using value_type = double;
+
+    /// number of temporary vectors provided by \ref vector
+    static constexpr size_type num_vectors = 6;
+
+
+  // ----- constructors / assignment -------------------------------------------
+  public:
+
+    /// default constructor, creates an empty workspace
+    krylov_workspace() = default;
+
+    /// constructor of a workspace for vectors of size n and a Krylov basis of dimension restart+1
+    explicit krylov_workspace(size_type n, size_type restart = 0)
+    {
+      resize(n, restart);
+    }
+
+    /// prepare the workspace for vectors of size n and a Krylov basis of dimension restart+1.
+    /// Memory is only reallocated if the sizes change.
+    void resize(size_type n, size_type restart = 0);
+
+    /// return the size of the vectors
+    size_type size() const
+    {
+      return size_;
+    }
+
+    /// return the restart length, i.e. the maximal dimension of the Krylov basis minus one
+    size_type restart() const
+    {
+      return restart_;
+    }
+
+
+  // ----- element access functions  -------------------------------------------
+  public:
+
+    /// access to the i-th temporary vector
+    dense_vector& vector(size_type i)
+    {
+      assert(i < num_vectors);
+      return vectors_[i];
+    }
+
+    /// access to the j-th Krylov basis vector
+    value_type* basis(size_type j)
+    {
+      assert(j <= restart_);
+      return basis_.data() + j * size_;
+    }
+
+    /// access to the j-th Krylov basis vector (const variant)
+    value_type const* basis(size_type j) const
+    {
+      assert(j <= restart_);
+      return basis_.data() + j * size_;
+    }
+
+    /// access to the (i,j)-th entry of the (restart+1) x restart Hessenberg matrix, stored column-wise
+    value_type& hessenberg(size_type i, size_type j)
+    {
+      assert(i <= restart_ && j < restart_);
+      return hessenberg_[j * (restart_+1) + i];
+    }
+
+    /// cosines of the Givens rotations
+    std::vector<value_type>& givens_cos() { return cs_; }
+
+    /// sines of the Givens rotations
+    std::vector<value_type>& givens_sin() { return sn_; }
+
+    /// right-hand side of the least-squares problem
+    std::vector<value_type>& rhs() { return g_; }
+
+
+  // ----- block operations on the Krylov basis  -------------------------------
+  public:
+
+    /// orthogonalize w against the first k basis vectors by classical Gram-Schmidt with one
+    /// re-orthogonalization, computing h = V^T w and w -= V h as matrix-vector products on
+    /// row blocks of the basis, distributed over the threads. Stores the coefficients in
+    /// h[0..k) and returns |w|_2.
+    value_type orthogonalize(size_type k, value_type* w, value_type* h);
+
+    /// computes x += V y with the first k basis vectors
+    void basis_mult_add(size_type k, value_type const* y, value_type* x) const;
+
+
+  // ----- data members  -------------------------------------------------------
+  private:
+
+    size_type size_ = 0;
+    size_type restart_ = 0;
+
+    std::vector<dense_vector> vectors_;
+    std::vector<value_type> basis_;
+    std::vector<value_type> hessenberg_;
+    std::vector<value_type> cs_, sn_, g_;
+    std::vector<value_type> coeffs_;    // Gram-Schmidt coefficients of one pass in orthogonalize
+    std::vector<value_type> partials_;  // per row block partial sums of the coefficients
+  };
+
+
+  /// Apply the stabilized bi-conjugate gradient algorithm to the linear system A*x = b, with
+  /// A a possibly non-symmetric matrix providing A.mult(x,y), and return an error code
+  /**
+   * \param A     The system matrix
+   * \param x     The solution vector. Must be of correct size.
+   * \param b     The load vector of the linear system
+   * \param iter  An iteration object controlling number of iterations and break tolerances.
+   * \param work  A workspace providing the temporary vectors, resized if necessary.
+   *
+   * \return The error code of the \ref iteration object. err=0 means no error, err=2 a
+   *         breakdown of the method.
+   **/
+  template <class Matrix>
+  int bicgstab(Matrix const& A, dense_vector& x, dense_vector const& b, iteration& iter,
+               krylov_workspace& work)
+  {
+    using std::abs;
+    using Scalar = typename dense_vector::value_type;
+
+    work.resize(b.size(), work.restart());
+    dense_vector& r     = work.vector(0);
+    dense_vector& r_hat = work.vector(1);
+    dense_vector& p     = work.vector(2);
+    dense_vector& v     = work.vector(3);
+    dense_vector& s     = work.vector(4);
+    dense_vector& t     = work.vector(5);
+
+    Scalar rho(0), rho_1(0), alpha(0), omega(0);
+
+    A.mult(x, r);
+    r.aypx(-1, b);        // r = b - A*x
+    r_hat = r;
+
+    while (! iter.finished(r)) {
+      ++iter;
+      rho = r_hat.dot(r);
+      if (abs(rho) == Scalar(0))
+        return iter.fail(2, "bicgstab: breakdown, r_hat^T*r = 0");
+
+      if (iter.first())
+        p = r;
+      else {
+        p.axpy(-omega, v);
+        p.aypx((rho / rho_1) * (alpha / omega), r); // p = r + beta * (p - omega * v)
+      }
+
+      A.mult(p, v);
+      Scalar const r_hat_v = r_hat.dot(v);
+      if (abs(r_hat_v) == Scalar(0))
+        return iter.fail(2, "bicgstab: breakdown, r_hat^T*v = 0");
+      alpha = rho / r_hat_v;
+
+      s = r;
+      s.axpy(-alpha, v);  // s = r - alpha * v
+
+      A.mult(s, t);
+      Scalar const tt = t.unary_dot();
+      omega = tt > Scalar(0) ? t.dot(s) / tt : Scalar(0);
+
+      x.axpy(alpha, p);   // x += alpha * p + omega * s
+      x.axpy(omega, s);
+
+      r = s;
+      r.axpy(-omega, t);  // r = s - omega * t
+
+      if (omega == Scalar(0) && ! iter.finished(r))
+        return iter.fail(2, "bicgstab: breakdown, omega = 0");
+      rho_1 = rho;
+    }
+
+    return iter;
+  }
+
+  /// Apply the stabilized bi-conjugate gradient algorithm with a temporary workspace
+  template <class Matrix>
+  int bicgstab(Matrix const& A, dense_vector& x, dense_vector const& b, iteration& iter)
+  {
+    krylov_workspace work(b.size());
+    return bicgstab(A, x, b, iter, work);
+  }
+
+
+  /// Apply the restarted generalized minimal residual algorithm GMRES(m) to the linear system
+  /// A*x = b, with A a possibly non-symmetric matrix providing A.mult(x,y) for vectors and for
+  /// vector views (see views.hh), and return an error code
+  /**
+   * \param A        The system matrix
+   * \param x        The solution vector. Must be of correct size.
+   * \param b        The load vector of the linear system
+   * \param iter     An iteration object controlling number of iterations and break tolerances.
+   * \param restart  The maximal dimension m of the Krylov space before restarting
+   * \param work     A workspace providing the Krylov basis, resized if necessary.
+   *
+   * \return The error code of the \ref iteration object. err=0 means no error.
+   **/
+  template <class Matrix>
+  int gmres(Matrix const& A, dense_vector& x, dense_vector const& b, iteration& iter,
+            std::size_t restart, krylov_workspace& work)
+  {
+    using std::abs;
+    using std::sqrt;
+    using size_type = typename krylov_workspace::size_type;
+    using Scalar    = typename dense_vector::value_type;
+
+    assert(restart > 0);
+    size_type const n = b.size();
+    work.resize(n, restart);
+    dense_vector& r = work.vector(0);
+    dense_vector& w = work.vector(1);
+    auto& cs = work.givens_cos();
+    auto& sn = work.givens_sin();
+    auto& g  = work.rhs();
+
+    A.mult(x, r);
+    r.aypx(-1, b);        // r = b - A*x
+    Scalar beta = r.two_norm();
+
+    // tolerance for the estimated residual inside a cycle. Only the true residual at a restart
+    // is passed to iter.finished(), since a finished iteration cannot be resumed.
+    Scalar const tol = iter.norm_r0() == 0 ? iter.atol() : std::max(iter.rtol() * iter.norm_r0(), iter.atol());
+
+    while (! iter.finished(beta)) {
+      // 1. start the Arnoldi process with v_0 = r / |r|
+      std::transform(r.data(), r.data() + n, work.basis(0), [beta](Scalar r_i) { return r_i / beta; });
+      std::fill(g.begin(), g.end(), Scalar(0));
+      g[0] = beta;
+
+      size_type k = 0;
+      while (k < restart) {
+        ++iter;
+        A.mult(const_vector_view(work.basis(k), n), vector_view(w));
+
+        // 2. orthogonalize w against the basis and store the coefficients in column k of H
+        Scalar* h = &work.hessenberg(0, k);
+        Scalar const h_next = work.orthogonalize(k+1, w.data(), h);
+        h[k+1] = h_next;
+
+        // 3. apply the previous Givens rotations to the new column and eliminate h[k+1]
+        for (size_type i = 0; i < k; ++i) {
+          Scalar const tmp = cs[i] * h[i] + sn[i] * h[i+1];
+          h[i+1] = -sn[i] * h[i] + cs[i] * h[i+1];
+          h[i]   = tmp;
+        }
+        Scalar const rr = sqrt(h[k] * h[k] + h[k+1] * h[k+1]);
+        cs[k] = h[k] / rr;
+        sn[k] = h[k+1] / rr;
+        h[k] = rr;
+        h[k+1] = 0;
+        g[k+1] = -sn[k] * g[k];
+        g[k]   =  cs[k] * g[k];
+        ++k;
+
+        // |g[k]| is the residual norm of the current least-squares solution
+        if (abs(g[k]) <= tol || iter.iterations() >= iter.max_iterations() || h_next == Scalar(0))
+          break;
+        std::transform(w.data(), w.data() + n, work.basis(k), [h_next](Scalar w_i) { return w_i / h_next; });
+      }
+
+      // 4. solve the triangular system H*y = g in-place and update x += V*y
+      for (size_type i = k; i-- > 0;) {
+        for (size_type j = i+1; j < k; ++j)
+          g[i] -= work.hessenberg(i, j) * g[j];
+        g[i] /= work.hessenberg(i, i);
+      }
+      work.basis_mult_add(k, g.data(), x.data());
+
+      // 5. restart with the true residual
+      A.mult(x, r);
+      r.aypx(-1, b);
+      beta = r.two_norm();
+    }
+
+    return iter;
+  }
+
+  /// Apply the restarted generalized minimal residual algorithm GMRES(m) with a temporary workspace
+  template <class Matrix>
+  int gmres(Matrix const& A, dense_vector& x, dense_vector const& b, iteration& iter,
+            std::size_t restart = 30)
+  {
+    krylov_workspace work(b.size(), restart);
+    return gmres(A, x, b, iter, restart, work);
+  }
+
+} // end namespace scprog
+
+#endif // SCPROG_KRYLOV_HH
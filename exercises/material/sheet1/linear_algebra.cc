@@ -1,13 +1,42 @@
 #include <iostream>
 #include "linear_algebra.hh"
+#include "parallel.hh"
+#include "reduction.hh"
+#include "views.hh"
 
 namespace scprog {
 
+namespace {
+
+  // computes y = y0 + A*x, or y = A*x if y0 is null, for vectors or vector views, with the
+  // rows distributed over the threads
+  template <class VectorX, class VectorY0, class VectorY>
+  void dense_mult_add(dense_matrix const& A, VectorX const& x, VectorY0 const* y0, VectorY& y)
+  {
+    using size_type  = typename dense_matrix::size_type;
+    using value_type = typename dense_matrix::value_type;
+    assert(x.size() == A.cols());
+    assert(y.size() == A.rows());
+    assert(!y0 || y0->size() == A.rows());
+    SCPROG_PRAGMA_OMP(parallel for schedule(static))
+    for (size_type r = 0; r < A.rows(); ++r) {
+      value_type const* row = A[r];
+      value_type y_r = y0 ? (*y0)[r] : value_type(0);
+      for (size_type c = 0; c < A.cols(); ++c)
+        y_r += row[c]*x[c];
+      y[r] = y_r;
+    }
+  }
+
+} // end anonymous namespace
+
+
 // set all entries of the vector to value v
 dense_vector& dense_vector::operator=(value_type v)
 {
-  for (auto& v_i : data_)
-    v_i = v;
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
+  for (size_type i = 0; i < data_.size(); ++i)
+    data_[i] = v;
   return *this;
 }
 
@@ -16,6 +45,7 @@ dense_vector& dense_vector::operator=(value_type v)
 dense_vector& dense_vector::operator+=(dense_vector const& that)
 {
   assert(size() == that.size());
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
   for (size_type i = 0; i < size(); ++i)
     data_[i] += that.data_[i];
   return *this;
@@ -26,6 +56,7 @@ dense_vector& dense_vector::operator+=(dense_vector const& that)
 dense_vector& dense_vector::operator-=(dense_vector const& that)
 {
   assert(size() == that.size());
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
   for (size_type i = 0; i < size(); ++i)
     data_[i] -= that.data_[i];
   return *this;
@@ -35,6 +66,7 @@ dense_vector& dense_vector::operator-=(dense_vector const& that)
 // perform update-assignment elementwise *= with a scalar
 dense_vector& dense_vector::operator*=(value_type s)
 {
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
   for (size_type i = 0; i < size(); ++i)
     data_[i] *= s;
   return *this;
@@ -45,6 +77,7 @@ dense_vector& dense_vector::operator*=(value_type s)
 dense_vector& dense_vector::operator/=(value_type s)
 {
   assert(s != value_type(0));
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
   for (size_type i = 0; i < size(); ++i)
     data_[i] /= s;
   return *this;
@@ -55,6 +88,7 @@ dense_vector& dense_vector::operator/=(value_type s)
 void dense_vector::axpy(value_type a, dense_vector const& x)
 {
   assert(size() == x.size());
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
   for (size_type i = 0; i < data_.size(); ++i)
     data_[i] += a * x.data_[i];
 }
@@ -64,6 +98,7 @@ void dense_vector::axpy(value_type a, dense_vector const& x)
 void dense_vector::aypx(value_type a, dense_vector const& x)
 {
   assert(size() == x.size());
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
   for (size_type i = 0; i < data_.size(); ++i)
     data_[i] = a * data_[i]  + x.data_[i];
 }
@@ -73,10 +108,7 @@ void dense_vector::aypx(value_type a, dense_vector const& x)
 typename dense_vector::value_type dense_vector::two_norm() const
 {
   using std::sqrt;
-  value_type result = 0;
-  for (auto const& d : data_)
-    result += d * d;
-  return sqrt(result);
+  return sqrt(unary_dot());
 }
 
 
@@ -95,10 +127,8 @@ typename dense_vector::value_type dense_vector::inf_norm() const
 // return v^T*v
 typename dense_vector::value_type dense_vector::unary_dot() const
 {
-  value_type result = 0;
-  for (auto const& d : data_)
-    result += d*d;
-  return result;
+  value_type const* v = data_.data();
+  return reduce_sum(size(), [v](size_type i) { return v[i] * v[i]; });
 }
 
 
@@ -106,10 +136,9 @@ typename dense_vector::value_type dense_vector::unary_dot() const
 typename dense_vector::value_type dense_vector::dot(dense_vector const& v2) const
 {
   assert(v2.size() == size());
-  value_type result = 0;
-  for (size_type i = 0; i < size(); ++i)
-    result += data_[i] * v2.data_[i];
-  return result;
+  value_type const* v = data_.data();
+  value_type const* w = v2.data_.data();
+  return reduce_sum(size(), [v,w](size_type i) { return v[i] * w[i]; });
 }
 
 // construct a matrix from initializer lists
@@ -129,6 +158,8 @@ dense_matrix::dense_matrix(std::initializer_list<std::initializer_list<value_typ
   data_.reserve(rows*columns);
   for (auto const& row : l)
     data_.insert(data_.end(), row.begin(), row.end());
+  rows_ = rows;
+  cols_ = columns;
 }
 
 
@@ -137,6 +168,7 @@ dense_matrix& dense_matrix::operator+=(dense_matrix const& that)
 {
   assert(rows() == that.rows());
   assert(cols() == that.cols());
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
   for (size_type i = 0; i < data_.size(); ++i)
     data_[i] += that.data_[i];
   return *this;
@@ -148,6 +180,7 @@ dense_matrix& dense_matrix::operator-=(dense_matrix const& that)
 {
   assert(rows() == that.rows());
   assert(cols() == that.cols());
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
   for (size_type i = 0; i < data_.size(); ++i)
     data_[i] -= that.data_[i];
   return *this;
@@ -157,8 +190,9 @@ dense_matrix& dense_matrix::operator-=(dense_matrix const& that)
 // set all entries to v
 dense_matrix& dense_matrix::operator=(value_type v)
 {
-  for (auto& A_ij : data_)
-    A_ij = v;
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
+  for (size_type i = 0; i < data_.size(); ++i)
+    data_[i] = v;
   return *this;
 }
 
@@ -176,29 +210,28 @@ dense_vector operator*(dense_matrix const& A, dense_vector const& x)
 // computes the matrix-vector product, y = Ax.
 void dense_matrix::mult(dense_vector const& x, dense_vector& y) const
 {
-  assert(x.size() == cols());
-  assert(y.size() == rows());
-  for (size_type r = 0; r < rows(); ++r) {
-    y[r] = value_type(0);
-    value_type const* row = (*this)[r];
-    for (size_type c = 0; c < cols(); ++c)
-      y[r] += row[c]*x[c];
-  }
+  dense_mult_add(*this, x, static_cast<dense_vector const*>(nullptr), y);
 }
 
 
 // computes v3 = v2 + A * v1.
 void dense_matrix::mult_add(dense_vector const& v1, dense_vector const& v2, dense_vector& v3) const
 {
-  assert(v1.size() == cols());
-  assert(v2.size() == rows());
-  assert(v3.size() == rows());
-  for (size_type r = 0; r < rows(); ++r) {
-    v3[r] = v2[r];
-    value_type const* row = (*this)[r];
-    for (size_type c = 0; c < cols(); ++c)
-      v3[r] += row[c]*v1[c];
-  }
+  dense_mult_add(*this, v1, &v2, v3);
+}
+
+
+// computes the matrix-vector product, y = Ax, for vector views
+void dense_matrix::mult(const_vector_view const& x, vector_view const& y) const
+{
+  dense_mult_add(*this, x, static_cast<const_vector_view const*>(nullptr), y);
+}
+
+
+// computes v3 = v2 + A * v1 for vector views
+void dense_matrix::mult_add(const_vector_view const& v1, const_vector_view const& v2, vector_view const& v3) const
+{
+  dense_mult_add(*this, v1, &v2, v3);
 }
 
 
@@ -207,6 +240,7 @@ void dense_matrix::axpy(value_type a, dense_matrix const& X)
 {
   assert(rows() == X.rows());
   assert(cols() == X.cols());
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
   for (size_type i = 0; i < data_.size(); ++i)
     data_[i] += a * X.data_[i];
 }
@@ -217,6 +251,7 @@ void dense_matrix::aypx(value_type a, dense_matrix const& X)
 {
   assert(rows() == X.rows());
   assert(cols() == X.cols());
+  SCPROG_PRAGMA_OMP(parallel for schedule(static))
   for (size_type i = 0; i < data_.size(); ++i)
     data_[i] = a * data_[i]  + X.data_[i];
 }
@@ -299,34 +334,7 @@ int iteration::error_code() const
 // Apply the conjugate gradient algorithm to the linear system A*x = b and return the number of iterations
 int cg(dense_matrix const& A, dense_vector& x, dense_vector const& b, iteration& iter)
 {
-  using std::abs;
-  using Vector = dense_vector;
-  using Scalar = typename dense_vector::value_type;
-  using Real   = typename iteration::real_type;
-
-  Scalar rho(0), rho_1(0), alpha(0);
-  Vector p(b), q(b), z(b);
-  Vector r(b - A*x);
-
-  rho = r.unary_dot();
-  while (! iter.finished(Real(sqrt(abs(rho))))) {
-    ++iter;
-    if (iter.first())
-      p = r;
-    else
-      p.aypx(rho / rho_1, r); // p = r + (rho / rho_1) * p;
-
-    q = A * p;
-    alpha = rho / p.dot(q);
-
-    x.axpy(alpha, p);     // x += alpha * p
-    r.axpy(-alpha, q);    // r -= alpha * q
-
-    rho_1 = rho;
-    rho = r.unary_dot();  // rho = r^T * r
-  }
-
-  return iter;
+  return cg<dense_matrix>(A, x, b, iter, impl::no_observer{});
 }
 
 } // end namespace scprog
\ No newline at end of file
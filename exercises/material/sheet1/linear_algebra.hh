@@ -1,3 +1,6 @@
+#ifndef SCPROG_LINEAR_ALGEBRA_HH
+#define SCPROG_LINEAR_ALGEBRA_HH
+
 #include <cassert>
 #include <cmath>
 #include <complex>
@@ -5,8 +8,15 @@
 #include <string>
 #include <vector>
 
+#include "allocator.hh"
+
 namespace scprog
 {
+  // non-owning views on vector entries, see views.hh
+  template <class T>
+  class basic_vector_view;
+
+
   /// A contiguous vector with vector-space operations
   class dense_vector
   {
@@ -28,8 +38,33 @@ namespace scprog
 
     /// constructor of vector with size s and all entries initialized with value v
     explicit dense_vector(size_type s, value_type v = value_type{})
-      : data_(s, v)
-    {}
+      : data_(s)
+    {
+      first_touch_fill(data_.data(), s, 1, v);
+    }
+
+    /// copy constructor, initializing the entries according to the \ref first_touch_mode
+    dense_vector(dense_vector const& that)
+      : data_(that.size())
+    {
+      first_touch_copy(data_.data(), that.data_.data(), that.size(), 1);
+    }
+
+    dense_vector(dense_vector&&) = default;
+
+    /// copy assignment, reallocating uninitialized memory if the sizes differ and copying the
+    /// entries according to the \ref first_touch_mode
+    dense_vector& operator=(dense_vector const& that)
+    {
+      if (this != &that) {
+        if (size() != that.size())
+          storage_type(that.size()).swap(data_);
+        first_touch_copy(data_.data(), that.data_.data(), that.size(), 1);
+      }
+      return *this;
+    }
+
+    dense_vector& operator=(dense_vector&&) = default;
 
     /// constructor with vector entries initialized by initializer_list
     explicit dense_vector(std::initializer_list<value_type> l)
@@ -42,7 +77,10 @@ namespace scprog
     /// resize vector to size s and fill new entries with value v
     void resize(size_type s, value_type v = value_type{})
     {
-      data_.resize(s, v);
+      size_type const old_size = data_.size();
+      data_.resize(s);
+      if (s > old_size)
+        first_touch_fill(data_.data() + old_size, s - old_size, 1, v);
     }
 
     /// return the number of elements in the vector
@@ -85,6 +123,18 @@ namespace scprog
       return data_[i];
     }
 
+    /// return a pointer to the contiguous vector entries
+    pointer data()
+    {
+      return data_.data();
+    }
+
+    /// return a const pointer to the contiguous vector entries
+    const_pointer data() const
+    {
+      return data_.data();
+    }
+
 
   // ----- binary operations  ---------------------------------------------------
   public:
@@ -139,7 +189,8 @@ namespace scprog
   // ----- data members  -------------------------------------------------------
   private:
 
-    std::vector<value_type> data_;
+    using storage_type = std::vector<value_type, first_touch_allocator<value_type>>;
+    storage_type data_;
   };
 
 
@@ -164,10 +215,39 @@ namespace scprog
 
     /// constructor of matrix with rows r, columns c and all entries initialized with value v
     explicit dense_matrix(size_type r, size_type c, value_type v = value_type{})
-      : data_(r*c, v)
+      : data_(r*c)
       , rows_(r)
       , cols_(c)
-    {}
+    {
+      first_touch_fill(data_.data(), r, c, v);
+    }
+
+    /// copy constructor, initializing the rows according to the \ref first_touch_mode
+    dense_matrix(dense_matrix const& that)
+      : data_(that.data_.size())
+      , rows_(that.rows_)
+      , cols_(that.cols_)
+    {
+      first_touch_copy(data_.data(), that.data_.data(), rows_, cols_);
+    }
+
+    dense_matrix(dense_matrix&&) = default;
+
+    /// copy assignment, reallocating uninitialized memory if the sizes differ and copying the
+    /// rows according to the \ref first_touch_mode
+    dense_matrix& operator=(dense_matrix const& that)
+    {
+      if (this != &that) {
+        if (data_.size() != that.data_.size())
+          storage_type(that.data_.size()).swap(data_);
+        rows_ = that.rows_;
+        cols_ = that.cols_;
+        first_touch_copy(data_.data(), that.data_.data(), rows_, cols_);
+      }
+      return *this;
+    }
+
+    dense_matrix& operator=(dense_matrix&&) = default;
 
     /// constructor with matrix entries initialized by initializer_list
     explicit dense_matrix(std::initializer_list<std::initializer_list<value_type>> l);
@@ -178,7 +258,10 @@ namespace scprog
     /// resize matrix to rows r and columns c and fill new entries with value v
     void resize(size_type r, size_type c, value_type v = value_type{})
     {
-      data_.resize(r*c, v);
+      size_type const old_size = data_.size();
+      data_.resize(r*c);
+      if (r*c > old_size)
+        first_touch_fill(data_.data() + old_size, r*c - old_size, 1, v);
       rows_ = r;
       cols_ = c;
     }
@@ -225,6 +308,18 @@ namespace scprog
       return data_[cols_ * r + c];
     }
 
+    /// return a pointer to the row-wise contiguous matrix entries
+    pointer data()
+    {
+      return data_.data();
+    }
+
+    /// return a const pointer to the row-wise contiguous matrix entries
+    const_pointer data() const
+    {
+      return data_.data();
+    }
+
 
   // ----- binary operations  ---------------------------------------------------
   public:
@@ -256,6 +351,14 @@ namespace scprog
     /// computes v3 = v2 + A * v1.
     void mult_add(dense_vector const& v1, dense_vector const& v2, dense_vector& v3) const;
 
+    /// computes the matrix-vector product, y = Ax, for views on vector entries (see views.hh),
+    /// e.g. parts of larger vectors. x and y must not overlap.
+    void mult(basic_vector_view<value_type const> const& x, basic_vector_view<value_type> const& y) const;
+
+    /// computes v3 = v2 + A * v1 for views on vector entries. v1 and v3 must not overlap.
+    void mult_add(basic_vector_view<value_type const> const& v1, basic_vector_view<value_type const> const& v2,
+                  basic_vector_view<value_type> const& v3) const;
+
     /// computes Y = a*X + Y.
     void axpy(value_type a, dense_matrix const& X);
 
@@ -266,7 +369,8 @@ namespace scprog
   // ----- data members  -------------------------------------------------------
   private:
 
-    std::vector<value_type> data_;
+    using storage_type = std::vector<value_type, first_touch_allocator<value_type>>;
+    storage_type data_;
     size_type rows_ = 0;
     size_type cols_ = 0;
   };
@@ -459,4 +563,66 @@ namespace scprog
   int cg(dense_matrix const& A, dense_vector& x, dense_vector const& b, iteration& iter);
 
 
-} // end namespace scprog
\ No newline at end of file
+  namespace impl
+  {
+    // coefficient observer of cg that ignores all coefficients
+    struct no_observer
+    {
+      void operator()(double /*alpha*/, double /*beta*/) const {}
+    };
+
+  } // end namespace impl
+
+  /// Apply the conjugate gradient algorithm to the linear system A*x = b and return an error code
+  /**
+   * \param A         The system matrix, providing A.mult(x,y)
+   * \param x         The solution vector. Must be of correct size.
+   * \param b         The load vector of the linear system
+   * \param iter      An iteration object controlling number of iterations and break tolerances.
+   * \param observer  Called as observer(alpha, beta) in each iteration with the step size alpha
+   *                  and the coefficient beta = rho/rho_1 of the search direction (0 in the
+   *                  first iteration), e.g. a \ref lanczos_estimator
+   *
+   * \return The error code of the \ref iteration object. err=0 means no error.
+   **/
+  template <class Matrix, class Observer = impl::no_observer>
+  int cg(Matrix const& A, dense_vector& x, dense_vector const& b, iteration& iter,
+         Observer&& observer = Observer{})
+  {
+    using std::abs;
+    using std::sqrt;
+    using Scalar = typename dense_vector::value_type;
+    using Real   = typename iteration::real_type;
+
+    Scalar rho(0), rho_1(0), alpha(0);
+    dense_vector p(b.size()), q(b.size());
+    dense_vector r(b.size());
+    A.mult(x, r);
+    r.aypx(-1, b);          // r = b - A*x
+
+    rho = r.unary_dot();
+    while (! iter.finished(Real(sqrt(abs(rho))))) {
+      ++iter;
+      if (iter.first())
+        p = r;
+      else
+        p.aypx(rho / rho_1, r); // p = r + (rho / rho_1) * p;
+
+      A.mult(p, q);
+      alpha = rho / p.dot(q);
+      observer(alpha, iter.first() ? Scalar(0) : rho / rho_1);
+
+      x.axpy(alpha, p);     // x += alpha * p
+      r.axpy(-alpha, q);    // r -= alpha * q
+
+      rho_1 = rho;
+      rho = r.unary_dot();  // rho = r^T * r
+    }
+
+    return iter;
+  }
+
+
+} // end namespace scprog
+
+#endif // SCPROG_LINEAR_ALGEBRA_HH
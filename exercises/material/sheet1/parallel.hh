@@ -0,0 +1,17 @@
+#ifndef SCPROG_PARALLEL_HH
+#define SCPROG_PARALLEL_HH
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/// Shared-memory parallelization by OpenMP. Compile with -fopenmp to enable, otherwise all
+/// loops run serially and the directives are removed without unknown-pragma warnings.
+#define SCPROG_STRINGIFY(x) #x
+#ifdef _OPENMP
+  #define SCPROG_PRAGMA_OMP(directive) _Pragma(SCPROG_STRINGIFY(omp directive))
+#else
+  #define SCPROG_PRAGMA_OMP(directive)
+#endif
+
+#endif // SCPROG_PARALLEL_HH
@@ -0,0 +1,123 @@
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "poisson_solver.hh"
+
+namespace scprog {
+
+namespace {
+
+  using complex_type = typename fft_plan::complex_type;
+
+  // DST-I of the one or two lines of length len = plan.size()/2 - 1, starting at offset
+  // first and second in x with the given stride. Both real lines are packed into one complex
+  // odd extension z = y1 + i*y2, whose FFT is Z = -2i*X1 + 2*X2. The buffer work is the
+  // scratch space of the FFT.
+  void dst_lines(fft_plan const& plan, std::vector<complex_type>& z, std::vector<complex_type>& work,
+                 dense_vector& x, std::size_t stride, std::size_t first, std::size_t second, bool has_second)
+  {
+    std::size_t const N = plan.size();
+    std::size_t const len = N / 2 - 1;
+
+    z[0] = z[len + 1] = complex_type(0);
+    for (std::size_t j = 1; j <= len; ++j) {
+      double const y2 = has_second ? x[second + (j-1)*stride] : 0.0;
+      z[j] = complex_type(x[first + (j-1)*stride], y2);
+      z[N - j] = -z[j];
+    }
+
+    plan.forward(z, work);
+
+    for (std::size_t k = 1; k <= len; ++k) {
+      x[first + (k-1)*stride] = -0.5 * z[k].imag();
+      if (has_second)
+        x[second + (k-1)*stride] = 0.5 * z[k].real();
+    }
+  }
+
+} // end anonymous namespace
+
+
+// constructor of the solver for an m x n grid
+poisson_solver::poisson_solver(size_type m, size_type n)
+  : m_(m)
+  , n_(n)
+  , fft_m_(2*(m+1))
+  , fft_n_(2*(n+1))
+  , lambda_m_(m)
+  , lambda_n_(n)
+{
+  using std::cos;
+  value_type const pi = std::acos(value_type(-1));
+  for (size_type p = 0; p < m; ++p)
+    lambda_m_[p] = 2 - 2*cos((p+1)*pi/(m+1));
+  for (size_type q = 0; q < n; ++q)
+    lambda_n_[q] = 2 - 2*cos((q+1)*pi/(n+1));
+}
+
+
+// in-place DST-I along all grid rows
+void poisson_solver::dst_rows(dense_vector& x) const
+{
+  std::vector<complex_type> z(fft_n_.size()), work(fft_n_.work_size());
+  for (size_type i = 0; i < m_; i += 2)
+    dst_lines(fft_n_, z, work, x, 1, i*n_, (i+1)*n_, i+1 < m_);
+}
+
+
+// in-place DST-I along all grid columns
+void poisson_solver::dst_cols(dense_vector& x) const
+{
+  std::vector<complex_type> z(fft_m_.size()), work(fft_m_.work_size());
+  for (size_type j = 0; j < n_; j += 2)
+    dst_lines(fft_m_, z, work, x, n_, j, j+1, j+1 < n_);
+}
+
+
+// solve A*x = b
+void poisson_solver::solve(dense_vector& x, dense_vector const& b) const
+{
+  assert(b.size() == m_*n_);
+  assert(x.size() == m_*n_);
+
+  // 1. transform the right-hand side, b_hat = S*b
+  x = b;
+  dst_rows(x);
+  dst_cols(x);
+
+  // 2. scale by the inverse eigenvalues and the normalization of S*S = (m+1)(n+1)/4
+  value_type const scale = value_type(4) / value_type((m_+1)*(n_+1));
+  for (size_type i = 0; i < m_; ++i)
+    for (size_type j = 0; j < n_; ++j)
+      x[i*n_ + j] *= scale / (lambda_m_[i] + lambda_n_[j]);
+
+  // 3. transform back, x = S*x_hat
+  dst_rows(x);
+  dst_cols(x);
+}
+
+
+// Return a cached solver for the m x n grid
+std::shared_ptr<poisson_solver const> get_poisson_solver(std::size_t m, std::size_t n)
+{
+  static std::mutex mutex;
+  static std::map<std::pair<std::size_t,std::size_t>, std::shared_ptr<poisson_solver const>> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& solver = cache[std::make_pair(m,n)];
+  if (!solver)
+    solver = std::make_shared<poisson_solver const>(m, n);
+  return solver;
+}
+
+
+// Solve the system A*x = b using the cached fast Poisson solver of the grid
+void poisson_solve(dense_vector& x, dense_vector const& b, std::size_t m, std::size_t n)
+{
+  get_poisson_solver(m, n)->solve(x, b);
+}
+
+} // end namespace scprog
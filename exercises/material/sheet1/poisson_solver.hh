@@ -0,0 +1,82 @@
+#ifndef SCPROG_POISSON_SOLVER_HH
+#define SCPROG_POISSON_SOLVER_HH
+
+#include <memory>
+#include <vector>
+
+#include "fft.hh"
+#include "linear_algebra.hh"
+
+namespace scprog
+{
+  /// Direct solver for the five-point Laplacian A of size (m*n) x (m*n) assembled by
+  /// \ref laplacian_setup. A is diagonalized by the 2D discrete sine transform (DST-I), thus
+  ///   x = S * Lambda^{-1} * S * b,
+  /// with the eigenvalues Lambda_pq = 4 - 2*cos(p*pi/(m+1)) - 2*cos(q*pi/(n+1)). Each DST of
+  /// length n is computed by an FFT of length 2(n+1), so the cost of a solve is O(N log N).
+  /// Choose n+1 and m+1 as powers of two to get the radix-2 fast path.
+  class poisson_solver
+  {
+  public:
+    using size_type  = std::size_t;
+    using value_type = double;
+
+
+  // ----- constructors / assignment -------------------------------------------
+  public:
+
+    /// constructor of the solver for an m x n grid, precomputing the FFT plans and eigenvalues
+    poisson_solver(size_type m, size_type n);
+
+    /// return the number of grid rows
+    size_type rows() const
+    {
+      return m_;
+    }
+
+    /// return the number of grid columns
+    size_type cols() const
+    {
+      return n_;
+    }
+
+
+  // ----- solve  --------------------------------------------------------------
+  public:
+
+    /// solve A*x = b, with x and b of size m*n in the row-wise grid numbering of \ref laplacian_setup
+    void solve(dense_vector& x, dense_vector const& b) const;
+
+
+  private:
+
+    // in-place DST-I along all grid rows (lines of length n_) or grid columns (lines of length m_)
+    void dst_rows(dense_vector& x) const;
+    void dst_cols(dense_vector& x) const;
+
+
+  // ----- data members  -------------------------------------------------------
+  private:
+
+    size_type m_;
+    size_type n_;
+
+    fft_plan fft_m_;  // plan of length 2(m+1)
+    fft_plan fft_n_;  // plan of length 2(n+1)
+
+    std::vector<value_type> lambda_m_;  // 2 - 2*cos(p*pi/(m+1)), p = 1,...,m
+    std::vector<value_type> lambda_n_;  // 2 - 2*cos(q*pi/(n+1)), q = 1,...,n
+  };
+
+
+  /// Return a solver for the m x n grid. Solvers are cached per (m,n), so repeated calls for
+  /// the same grid skip the plan setup.
+  std::shared_ptr<poisson_solver const> get_poisson_solver(std::size_t m, std::size_t n);
+
+  /// Solve the system A*x = b for the matrix A assembled by laplacian_setup(A, m, n) using the
+  /// cached fast Poisson solver of the grid
+  void poisson_solve(dense_vector& x, dense_vector const& b, std::size_t m, std::size_t n);
+
+} // end namespace scprog
+
+#endif // SCPROG_POISSON_SOLVER_HH
@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "recycling.hh"
+
+namespace scprog {
+
+namespace {
+
+  // Eigenvalues and eigenvectors of the small symmetric matrix A by the cyclic Jacobi method.
+  // A is overwritten with its eigenvalues on the diagonal, the columns of V are the eigenvectors.
+  void jacobi_eigen(dense_matrix& A, dense_matrix& V)
+  {
+    using std::abs;
+    using std::sqrt;
+    std::size_t const n = A.rows();
+    V.resize(n, n);
+    V = 0;
+    for (std::size_t i = 0; i < n; ++i)
+      V(i,i) = 1;
+
+    for (int sweep = 0; sweep < 100; ++sweep) {
+      double off = 0, total = 0;
+      for (std::size_t p = 0; p < n; ++p) {
+        total += A(p,p) * A(p,p);
+        for (std::size_t q = p+1; q < n; ++q)
+          off += A(p,q) * A(p,q);
+      }
+      if (off <= 1.e-30 * (total + off))
+        break;
+
+      for (std::size_t p = 0; p < n; ++p) {
+        for (std::size_t q = p+1; q < n; ++q) {
+          if (A(p,q) == 0.0)
+            continue;
+
+          // rotation annihilating A(p,q)
+          double const theta = (A(q,q) - A(p,p)) / (2 * A(p,q));
+          double const t = (theta < 0 ? -1.0 : 1.0) / (abs(theta) + sqrt(theta*theta + 1));
+          double const c = 1 / sqrt(t*t + 1);
+          double const s = t * c;
+
+          for (std::size_t k = 0; k < n; ++k) {
+            double const a_kp = A(k,p), a_kq = A(k,q);
+            A(k,p) = c * a_kp - s * a_kq;
+            A(k,q) = s * a_kp + c * a_kq;
+          }
+          for (std::size_t k = 0; k < n; ++k) {
+            double const a_pk = A(p,k), a_qk = A(q,k);
+            A(p,k) = c * a_pk - s * a_qk;
+            A(q,k) = s * a_pk + c * a_qk;
+          }
+          for (std::size_t k = 0; k < n; ++k) {
+            double const v_kp = V(k,p), v_kq = V(k,q);
+            V(k,p) = c * v_kp - s * v_kq;
+            V(k,q) = s * v_kp + c * v_kq;
+          }
+        }
+      }
+    }
+  }
+
+
+  // A-orthogonalize v against the A-orthonormal vectors U, with Av = A*v and AU = A*U updated
+  // accordingly. Two passes of classical Gram-Schmidt for stability.
+  template <class Container>
+  void a_orthogonalize(dense_vector& v, dense_vector& Av, Container const& U, Container const& AU)
+  {
+    for (int pass = 0; pass < 2; ++pass) {
+      for (std::size_t j = 0; j < U.size(); ++j) {
+        double const c = AU[j].dot(v);  // u_j^T * A * v
+        v.axpy(-c, U[j]);
+        Av.axpy(-c, AU[j]);
+      }
+    }
+  }
+
+} // end anonymous namespace
+
+
+// remove all recycled information
+void recycling_cg::clear()
+{
+  W_.clear();
+  AW_.clear();
+  V_.clear();
+  AV_.clear();
+  P_.clear();
+  AP_.clear();
+  X_.clear();
+  AX_.clear();
+}
+
+
+// Galerkin projections of the error onto span X and then onto span W
+void recycling_cg::project(dense_vector& x, dense_vector& r) const
+{
+  for (size_type j = 0; j < X_.size(); ++j) {
+    value_type const c = X_[j].dot(r);
+    x.axpy(c, X_[j]);
+    r.axpy(-c, AX_[j]);
+  }
+  for (size_type j = 0; j < W_.size(); ++j) {
+    value_type const c = W_[j].dot(r);
+    x.axpy(c, W_[j]);
+    r.axpy(-c, AW_[j]);
+  }
+}
+
+
+// p -= W * (A*W)^T * r
+void recycling_cg::deflate(dense_vector& p, dense_vector const& r) const
+{
+  for (size_type j = 0; j < W_.size(); ++j)
+    p.axpy(-AW_[j].dot(r), W_[j]);
+}
+
+
+// store the normalized search direction p and q = A*p, refine the candidate space if P is full
+void recycling_cg::record(dense_vector const& p, dense_vector const& q)
+{
+  value_type const norm = p.two_norm();
+  if (norm > value_type(0)) {
+    P_.push_back(p);
+    P_.back() /= norm;
+    AP_.push_back(q);
+    AP_.back() /= norm;
+  }
+
+  if (P_.size() >= directions_)
+    refine();
+}
+
+
+// replace V by the Ritz vectors of the smallest Ritz values in span[V, P] and clear P
+void recycling_cg::refine()
+{
+  using std::sqrt;
+
+  // 1. basis Z = [V, P] of the search space, with images AZ
+  std::vector<dense_vector const*> Z, AZ;
+  for (size_type j = 0; j < V_.size(); ++j) {
+    Z.push_back(&V_[j]);
+    AZ.push_back(&AV_[j]);
+  }
+  for (size_type j = 0; j < P_.size(); ++j) {
+    Z.push_back(&P_[j]);
+    AZ.push_back(&AP_[j]);
+  }
+  size_type const l = Z.size();
+  if (l == 0 || deflation_ == 0) {
+    P_.clear();
+    AP_.clear();
+    return;
+  }
+
+  // 2. Gram matrix F = Z^T*Z and projected matrix G = Z^T*A*Z, scaled to unit diagonal of F
+  dense_matrix F(l, l), G(l, l);
+  for (size_type i = 0; i < l; ++i) {
+    for (size_type j = i; j < l; ++j) {
+      F(i,j) = F(j,i) = Z[i]->dot(*Z[j]);
+      G(i,j) = G(j,i) = 0.5 * (Z[i]->dot(*AZ[j]) + Z[j]->dot(*AZ[i]));
+    }
+  }
+  std::vector<value_type> scale(l);
+  for (size_type i = 0; i < l; ++i)
+    scale[i] = 1 / sqrt(F(i,i));
+  for (size_type i = 0; i < l; ++i) {
+    for (size_type j = 0; j < l; ++j) {
+      F(i,j) *= scale[i] * scale[j];
+      G(i,j) *= scale[i] * scale[j];
+    }
+  }
+
+  // 3. orthonormal basis T of span Z, dropping numerically dependent directions: F = Q*D*Q^T, T = Q*D^{-1/2}
+  dense_matrix Q;
+  jacobi_eigen(F, Q);
+  value_type d_max = 0;
+  for (size_type i = 0; i < l; ++i)
+    d_max = std::max(d_max, F(i,i));
+  std::vector<size_type> keep;
+  for (size_type i = 0; i < l; ++i) {
+    if (F(i,i) > 1.e-10 * d_max)
+      keep.push_back(i);
+  }
+  size_type const rank = keep.size();
+  dense_matrix T(l, rank);
+  for (size_type i = 0; i < l; ++i)
+    for (size_type k = 0; k < rank; ++k)
+      T(i,k) = Q(i,keep[k]) / sqrt(F(keep[k],keep[k]));
+
+  // 4. Ritz pairs from the eigen decomposition of H = T^T*G*T
+  dense_matrix GT(l, rank, 0.0), H(rank, rank, 0.0), Y;
+  for (size_type i = 0; i < l; ++i)
+    for (size_type j = 0; j < l; ++j)
+      for (size_type k = 0; k < rank; ++k)
+        GT(i,k) += G(i,j) * T(j,k);
+  for (size_type i = 0; i < rank; ++i)
+    for (size_type j = 0; j < l; ++j)
+      for (size_type k = 0; k < rank; ++k)
+        H(i,k) += T(j,i) * GT(j,k);
+  jacobi_eigen(H, Y);
+
+  std::vector<size_type> order(rank);
+  std::iota(order.begin(), order.end(), size_type(0));
+  std::sort(order.begin(), order.end(), [&H](size_type a, size_type b) { return H(a,a) < H(b,b); });
+
+  // 5. new candidate vectors v = Z*S*T*y / sqrt(theta), A-orthonormal since y^T*H*y = theta
+  std::vector<dense_vector> V, AV;
+  for (size_type k = 0; k < rank && V.size() < deflation_; ++k) {
+    value_type const theta = H(order[k], order[k]);
+    if (theta <= value_type(0))
+      continue;
+
+    V.emplace_back(size_, 0.0);
+    AV.emplace_back(size_, 0.0);
+    for (size_type i = 0; i < l; ++i) {
+      value_type c = 0;
+      for (size_type j = 0; j < rank; ++j)
+        c += T(i,j) * Y(j,order[k]);
+      c *= scale[i] / sqrt(theta);
+      V.back().axpy(c, *Z[i]);
+      AV.back().axpy(c, *AZ[i]);
+    }
+  }
+
+  V_ = std::move(V);
+  AV_ = std::move(AV);
+  P_.clear();
+  AP_.clear();
+}
+
+
+// A-orthonormalize the solution x against X and append it to the history
+void recycling_cg::add_solution(dense_vector x, dense_vector Ax)
+{
+  using std::sqrt;
+  if (history_ == 0)
+    return;
+
+  // drop the oldest solution first, x has to be representable by the remaining ones
+  if (X_.size() >= history_) {
+    X_.pop_front();
+    AX_.pop_front();
+  }
+
+  value_type const norm0 = sqrt(std::max(x.dot(Ax), value_type(0)));
+  a_orthogonalize(x, Ax, X_, AX_);
+
+  // skip solutions (numerically) contained in span X
+  value_type const norm = sqrt(std::max(x.dot(Ax), value_type(0)));
+  if (norm <= 1.e-8 * norm0)
+    return;
+
+  x /= norm;
+  Ax /= norm;
+  X_.push_back(std::move(x));
+  AX_.push_back(std::move(Ax));
+}
+
+
+// A-orthonormalize W and X, each among itself
+void recycling_cg::orthonormalize()
+{
+  using std::sqrt;
+
+  // W is A-orthonormal by construction, up to round-off or a changed matrix
+  std::vector<dense_vector> W, AW;
+  std::swap(W, W_);
+  std::swap(AW, AW_);
+  for (size_type j = 0; j < W.size(); ++j) {
+    value_type const norm0 = sqrt(std::max(W[j].dot(AW[j]), value_type(0)));
+    a_orthogonalize(W[j], AW[j], W_, AW_);
+    value_type const norm = sqrt(std::max(W[j].dot(AW[j]), value_type(0)));
+    if (norm > 1.e-8 * norm0) {
+      W_.push_back(W[j] /= norm);
+      AW_.push_back(AW[j] /= norm);
+    }
+  }
+
+  std::deque<dense_vector> X, AX;
+  std::swap(X, X_);
+  std::swap(AX, AX_);
+  for (size_type j = 0; j < X.size(); ++j)
+    add_solution(std::move(X[j]), std::move(AX[j]));
+}
+
+} // end namespace scprog
@@ -0,0 +1,189 @@
+#ifndef SCPROG_RECYCLING_HH
+#define SCPROG_RECYCLING_HH
+
+#include <cmath>
+#include <deque>
+#include <vector>
+
+#include "linear_algebra.hh"
+
+namespace scprog
+{
+  /// Conjugate gradient solver for sequences of linear systems A*x = b with the same or a
+  /// slowly changing symmetric positive definite matrix, recycling information between solves:
+  ///
+  /// - Deflation: a subspace W of approximate eigenvectors for the smallest eigenvalues is kept,
+  ///   and the search directions are kept A-orthogonal to W (deflated CG), removing these modes
+  ///   from the convergence. During a solve, a candidate space V (starting from W) is refined
+  ///   by the Rayleigh-Ritz procedure on span[V, P] for each block P of recorded search
+  ///   directions, and replaces W for the next solve.
+  /// - Warm start: the initial guess is improved by the Galerkin projections onto span X, with
+  ///   X the last solutions, and onto span W.
+  ///
+  /// W and X are each stored A-orthonormal together with their images A*W and A*X, so neither
+  /// the projections nor the deflation need a small linear system to be solved. The images are
+  /// only valid for the matrix they were computed with, and any change of A breaks deflation
+  /// with them. Therefore \ref solve recomputes them with the current matrix by default, at the
+  /// cost of |W| + |X| matrix-vector products, unless the matrix is declared to be the same.
+  class recycling_cg
+  {
+  public:
+    using size_type  = std::size_t;
+    using value_type = double;
+
+
+  // ----- constructors / assignment -------------------------------------------
+  public:
+
+    /// constructor of a solver keeping `deflation` approximate eigenvectors, refined after each
+    /// block of `directions` search directions, and the last `history` solutions
+    explicit recycling_cg(size_type deflation = 8, size_type directions = 16, size_type history = 4)
+      : deflation_(deflation)
+      , directions_(directions)
+      , history_(history)
+    {}
+
+    /// remove all recycled information
+    void clear();
+
+    /// return the current dimension of the deflation space
+    size_type num_deflation_vectors() const
+    {
+      return W_.size();
+    }
+
+    /// return the number of stored previous solutions
+    size_type num_solutions() const
+    {
+      return X_.size();
+    }
+
+
+  // ----- solve  --------------------------------------------------------------
+  public:
+
+    /// Apply the deflated conjugate gradient algorithm to A*x = b and return an error code
+    /**
+     * \param A     The system matrix, providing A.mult(x,y)
+     * \param x     The solution vector, with the initial guess. Must be of correct size.
+     * \param b     The load vector of the linear system
+     * \param iter  An iteration object controlling number of iterations and break tolerances.
+     * \param same_matrix  Whether A is unchanged since the last solve (or \ref refresh), such
+     *                     that the stored images A*W and A*X can be reused without recomputing.
+     *
+     * \return The error code of the \ref iteration object. err=0 means no error.
+     **/
+    template <class Matrix>
+    int solve(Matrix const& A, dense_vector& x, dense_vector const& b, iteration& iter,
+              bool same_matrix = false)
+    {
+      using std::abs;
+      using std::sqrt;
+      using Scalar = typename dense_vector::value_type;
+      using Real   = typename iteration::real_type;
+
+      if (b.size() != size_) {
+        clear();
+        size_ = b.size();
+      }
+      else if (!same_matrix)
+        refresh(A);
+
+      dense_vector r(b.size()), p(b.size()), q(b.size());
+      A.mult(x, r);
+      r.aypx(-1, b);        // r = b - A*x
+
+      // 1. initial guess by the Galerkin projections onto span X and span W, giving W^T*r = 0
+      if (!W_.empty() || !X_.empty()) {
+        project(x, r);
+        A.mult(x, r);
+        r.aypx(-1, b);
+      }
+
+      // 2. deflated CG, with search directions A-orthogonal to W
+      V_ = W_;
+      AV_ = AW_;
+      P_.clear();
+      AP_.clear();
+      Scalar rho(0), rho_1(0), alpha(0);
+      rho = r.unary_dot();
+      while (! iter.finished(Real(sqrt(abs(rho))))) {
+        ++iter;
+        if (iter.first())
+          p = r;
+        else
+          p.aypx(rho / rho_1, r); // p = r + (rho / rho_1) * p;
+        deflate(p, r);            // p -= W * (A*W)^T * r
+
+        A.mult(p, q);
+        alpha = rho / p.dot(q);
+        record(p, q);
+
+        x.axpy(alpha, p);     // x += alpha * p
+        r.axpy(-alpha, q);    // r -= alpha * q
+
+        rho_1 = rho;
+        rho = r.unary_dot();  // rho = r^T * r
+      }
+
+      // 3. update the recycled subspaces for the next solve
+      refine();
+      W_.swap(V_);
+      AW_.swap(AV_);
+      orthonormalize();
+      A.mult(x, q);
+      add_solution(x, q);
+
+      return iter;
+    }
+
+    /// recompute the images A*W and A*X with the matrix A, and re-A-orthonormalize W and X
+    template <class Matrix>
+    void refresh(Matrix const& A)
+    {
+      for (size_type j = 0; j < W_.size(); ++j)
+        A.mult(W_[j], AW_[j]);
+      for (size_type j = 0; j < X_.size(); ++j)
+        A.mult(X_[j], AX_[j]);
+      orthonormalize();
+    }
+
+
+  private:
+
+    // x += U * U^T * r and r -= A*U * U^T * r, for U = X and then U = W
+    void project(dense_vector& x, dense_vector& r) const;
+
+    // p -= W * (A*W)^T * r, making p A-orthogonal to W
+    void deflate(dense_vector& p, dense_vector const& r) const;
+
+    // store the search direction p and q = A*p normalized, and refine V if directions_ are stored
+    void record(dense_vector const& p, dense_vector const& q);
+
+    // replace V by the Ritz vectors of the smallest Ritz values in span[V, P] and clear P
+    void refine();
+
+    // A-orthonormalize the solution x against X and append it to the history
+    void add_solution(dense_vector x, dense_vector Ax);
+
+    // A-orthonormalize W and X, each among itself, dropping dependent vectors
+    void orthonormalize();
+
+
+  // ----- data members  -------------------------------------------------------
+  private:
+
+    size_type deflation_;
+    size_type directions_;
+    size_type history_;
+    size_type size_ = 0;
+
+    std::vector<dense_vector> W_, AW_;  // deflation space, A-orthonormal
+    std::vector<dense_vector> V_, AV_;  // candidate deflation space refined during a solve
+    std::vector<dense_vector> P_, AP_;  // recorded search directions since the last refinement
+    std::deque<dense_vector> X_, AX_;   // previous solutions, A-orthonormal
+  };
+
+} // end namespace scprog
+
+#endif // SCPROG_RECYCLING_HH
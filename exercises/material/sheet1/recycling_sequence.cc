@@ -0,0 +1,62 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "linear_algebra.hh"
+#include "recycling.hh"
+#include "sparse_matrix.hh"
+
+// Solve a sequence of diffusion problems -div(k_s grad u) = f_s with a slowly changing
+// coefficient k_s and right-hand side f_s, comparing CG with the recycling CG solver.
+// The coefficient changes by up to `change` per step, relative to its mean value 1, i.e. the
+// default 0.01 is a change of 1% per step.
+// Usage: recycling_sequence [change per step, default 0.01]
+int main(int argc, char** argv)
+{
+  using namespace scprog;
+  std::size_t const m = 60, n = 60, N = m*n;
+  double const change = argc > 1 ? std::atof(argv[1]) : 0.01;
+
+  recycling_cg solver;
+  dense_vector k(N);
+  dense_vector b(N);
+  sparse_matrix A;
+
+  int err = 0;
+  for (int s = 0; s < 8; ++s) {
+    // coefficient and load vector of step s
+    for (std::size_t i = 0; i < N; ++i) {
+      k[i] = 1.0 + 0.5 * std::sin(0.1*i) + change * s * std::cos(0.05*i);
+      b[i] = std::sin(0.3*i + s) + std::cos(0.013*i*(s+1));
+    }
+    diffusion_setup(A, k, m, n);
+
+    // reference solution by plain CG
+    dense_vector x0(N, 0.0);
+    iteration iter0(b, 2000, 1.e-8);
+    iter0.set_quite(true);
+    iter0.suppress_resume(true);
+    cg(A, x0, b, iter0);
+
+    // recycling CG, recomputing the stored images unless the matrix is unchanged
+    dense_vector x(N, 0.0);
+    iteration iter(b, 2000, 1.e-8);
+    iter.set_quite(true);
+    iter.suppress_resume(true);
+    err = solver.solve(A, x, b, iter, change == 0.0);
+
+    dense_vector r(N);
+    A.mult(x, r);
+    r.aypx(-1, b);
+    std::cout << "step " << s << ": cg " << iter0.iterations() << " iterations, recycling cg "
+              << iter.iterations() << " iterations, |b-A*x|/|b| = " << r.two_norm() / b.two_norm() << std::endl;
+
+    if (err) {
+      std::cerr << "ERROR: Linear system could not be solved.\n"
+                << "       |b-A*x| = " << iter.resid() << ", |b-A*x|/|b| = " << iter.relresid() << std::endl;
+      std::abort();
+    }
+  }
+
+  return err;
+}
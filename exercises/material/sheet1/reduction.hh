@@ -0,0 +1,94 @@
+#ifndef SCPROG_REDUCTION_HH
+#define SCPROG_REDUCTION_HH
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "parallel.hh"
+
+namespace scprog
+{
+  /// Summation order used by the parallel reductions, e.g. in dense_vector::dot
+  enum class reduction_mode
+  {
+    fast,         ///< plain parallel sum, the result may depend on the number of threads
+    reproducible  ///< fixed-order blocked summation, bitwise identical for any number of threads
+  };
+
+  namespace impl
+  {
+    // the process-wide reduction mode, shared by all translation units
+    inline std::atomic<reduction_mode>& current_reduction_mode()
+    {
+      static std::atomic<reduction_mode> mode{reduction_mode::fast};
+      return mode;
+    }
+
+  } // end namespace impl
+
+  /// Set the summation order of all subsequent reductions
+  inline void set_reduction_mode(reduction_mode mode)
+  {
+    impl::current_reduction_mode() = mode;
+  }
+
+  /// Return the current summation order of the reductions
+  inline reduction_mode get_reduction_mode()
+  {
+    return impl::current_reduction_mode();
+  }
+
+
+  /// Return sum_{i<n} f(i), computed according to the current \ref reduction_mode.
+  /**
+   * In the reproducible mode the range is split into blocks of fixed size, independent of the
+   * number of threads. Each block is summed sequentially with a fixed interleaving of four
+   * partial sums, and the block sums are combined by pairwise summation in a fixed tree. Only
+   * the distribution of the blocks over the threads depends on the thread count, not the
+   * order of any floating-point operation.
+   **/
+  template <class F>
+  double reduce_sum(std::size_t n, F f)
+  {
+    constexpr std::size_t block_size = 1024;
+
+    if (get_reduction_mode() == reduction_mode::fast) {
+      double result = 0;
+      SCPROG_PRAGMA_OMP(parallel for reduction(+:result) schedule(static))
+      for (std::size_t i = 0; i < n; ++i)
+        result += f(i);
+      return result;
+    }
+
+    // 1. sum of each block, with four interleaved partial sums
+    std::size_t const num_blocks = (n + block_size - 1) / block_size;
+    std::vector<double> sums(num_blocks);
+    SCPROG_PRAGMA_OMP(parallel for schedule(static))
+    for (std::size_t b = 0; b < num_blocks; ++b) {
+      std::size_t const i0 = b * block_size;
+      std::size_t const i1 = std::min(i0 + block_size, n);
+      double s[4] = {0.0, 0.0, 0.0, 0.0};
+      std::size_t i = i0;
+      for (; i + 4 <= i1; i += 4) {
+        s[0] += f(i);
+        s[1] += f(i+1);
+        s[2] += f(i+2);
+        s[3] += f(i+3);
+      }
+      for (; i < i1; ++i)
+        s[(i - i0) & 3] += f(i);
+      sums[b] = (s[0] + s[1]) + (s[2] + s[3]);
+    }
+
+    // 2. pairwise summation of the block sums
+    for (std::size_t stride = 1; stride < num_blocks; stride *= 2) {
+      for (std::size_t b = 0; b + stride < num_blocks; b += 2*stride)
+        sums[b] += sums[b + stride];
+    }
+    return num_blocks > 0 ? sums[0] : 0.0;
+  }
+
+} // end namespace scprog
+
+#endif // SCPROG_REDUCTION_HH
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <array>
+
+#include "parallel.hh"
+#include "sparse_matrix.hh"
+#include "views.hh"
+
+namespace scprog {
+
+namespace {
+
+  // Assemble the (2*dim+1)-point-stencil of -div(k grad u) on a grid with the given extents
+  // and homogeneous Dirichlet boundary. The functor face(r,s) returns the coefficient on the
+  // face between the grid points r and s, with face(r,r) used for the boundary faces of r.
+  // Rows are independent, so counting and filling is done in parallel directly into the
+  // compressed row arrays, without any intermediate dense or triplet storage.
+  template <std::size_t dim, class FaceCoeff>
+  void stencil_setup(sparse_matrix& A, std::array<std::size_t,dim> const& extent, FaceCoeff face)
+  {
+    using size_type  = typename sparse_matrix::size_type;
+    using value_type = typename sparse_matrix::value_type;
+
+    // grid point (i_0,...,i_{dim-1}) has the row index sum_d i_d * stride[d]
+    std::array<size_type,dim> stride;
+    stride[dim-1] = 1;
+    for (std::size_t d = dim-1; d > 0; --d)
+      stride[d-1] = stride[d] * extent[d];
+    size_type const N = stride[0] * extent[0];
+
+    // the grid is split into the slices of fixed first index, each traversed with a
+    // running multi-index to avoid divisions in the innermost loop
+    auto for_each_point = [&](size_type i0, auto&& f) {
+      std::array<size_type,dim> index{};
+      index[0] = i0;
+      for (size_type r = i0 * stride[0]; r < (i0+1) * stride[0]; ++r) {
+        f(r, index);
+        for (std::size_t d = dim-1; d > 0 && ++index[d] == extent[d]; --d)
+          index[d] = 0;
+      }
+    };
+
+    // 1. number of entries per row: the diagonal and all neighbors inside the grid, summed up
+    //    within each slice. The arrays are not initialized on allocation, so each slice is
+    //    first touched by the thread that fills it and later multiplies with it.
+    sparse_matrix::array_type<size_type> row_ptr(N+1);
+    std::vector<size_type> slice_ptr(extent[0]+1);
+    row_ptr[0] = 0;
+    slice_ptr[0] = 0;
+    SCPROG_PRAGMA_OMP(parallel for schedule(static))
+    for (size_type i0 = 0; i0 < extent[0]; ++i0) {
+      size_type sum = 0;
+      for_each_point(i0, [&](size_type r, std::array<size_type,dim> const& index) {
+        size_type count = 1;
+        for (std::size_t d = 0; d < dim; ++d)
+          count += (index[d] > 0 ? 1 : 0) + (index[d]+1 < extent[d] ? 1 : 0);
+        row_ptr[r+1] = sum += count;
+      });
+      slice_ptr[i0+1] = sum;
+    }
+
+    // prefix sum over the slices, then shift the rows of each slice by its offset
+    for (size_type i0 = 0; i0 < extent[0]; ++i0)
+      slice_ptr[i0+1] += slice_ptr[i0];
+    SCPROG_PRAGMA_OMP(parallel for schedule(static))
+    for (size_type i0 = 0; i0 < extent[0]; ++i0) {
+      for (size_type r = i0 * stride[0]; r < (i0+1) * stride[0]; ++r)
+        row_ptr[r+1] += slice_ptr[i0];
+    }
+
+    // 2. fill the rows with ascending column indices: lower neighbors, diagonal, upper neighbors
+    sparse_matrix::array_type<size_type> col_idx(row_ptr[N]);
+    sparse_matrix::array_type<value_type> values(row_ptr[N]);
+    SCPROG_PRAGMA_OMP(parallel for schedule(static))
+    for (size_type i0 = 0; i0 < extent[0]; ++i0) {
+      for_each_point(i0, [&](size_type r, std::array<size_type,dim> const& index) {
+        size_type pos = row_ptr[r];
+        value_type diagonal = 0;
+
+        for (std::size_t d = 0; d < dim; ++d) {
+          if (index[d] > 0) {
+            value_type const a = face(r, r - stride[d]);
+            col_idx[pos] = r - stride[d];
+            values[pos++] = -a;
+            diagonal += a;
+          } else
+            diagonal += face(r, r);
+        }
+
+        size_type const diag_pos = pos++;
+        col_idx[diag_pos] = r;
+
+        for (std::size_t d = dim; d-- > 0;) {
+          if (index[d]+1 < extent[d]) {
+            value_type const a = face(r, r + stride[d]);
+            col_idx[pos] = r + stride[d];
+            values[pos++] = -a;
+            diagonal += a;
+          } else
+            diagonal += face(r, r);
+        }
+        values[diag_pos] = diagonal;
+      });
+    }
+
+    A = sparse_matrix(N, N, std::move(row_ptr), std::move(col_idx), std::move(values));
+  }
+
+
+  // computes y = y0 + A*x, or y = A*x if y0 is null, for vectors or vector views, with the
+  // rows distributed over the threads
+  template <class VectorX, class VectorY0, class VectorY>
+  void sparse_mult_add(sparse_matrix const& A, VectorX const& x, VectorY0 const* y0, VectorY& y)
+  {
+    using size_type  = typename sparse_matrix::size_type;
+    using value_type = typename sparse_matrix::value_type;
+    assert(x.size() == A.cols());
+    assert(y.size() == A.rows());
+    assert(!y0 || y0->size() == A.rows());
+    size_type const* row_ptr = A.row_ptr().data();
+    size_type const* col_idx = A.col_idx().data();
+    value_type const* values = A.values().data();
+    SCPROG_PRAGMA_OMP(parallel for schedule(static))
+    for (size_type r = 0; r < A.rows(); ++r) {
+      value_type y_r = y0 ? (*y0)[r] : value_type(0);
+      for (size_type i = row_ptr[r]; i < row_ptr[r+1]; ++i)
+        y_r += values[i] * x[col_idx[i]];
+      y[r] = y_r;
+    }
+  }
+
+
+  // Face coefficient of the constant-coefficient Laplacian
+  struct unit_coefficient
+  {
+    double operator()(std::size_t, std::size_t) const { return 1.0; }
+  };
+
+
+  // Face coefficient as harmonic mean of the grid point coefficients
+  struct harmonic_coefficient
+  {
+    dense_vector const& k;
+
+    double operator()(std::size_t r, std::size_t s) const
+    {
+      return r == s ? k[r] : 2.0 * k[r] * k[s] / (k[r] + k[s]);
+    }
+  };
+
+} // end anonymous namespace
+
+
+// return the (r,c)-th matrix element, zero if it is not stored
+typename sparse_matrix::value_type sparse_matrix::operator()(size_type r, size_type c) const
+{
+  assert(r < rows_);
+  assert(c < cols_);
+  auto first = col_idx_.begin() + row_ptr_[r];
+  auto last  = col_idx_.begin() + row_ptr_[r+1];
+  auto it = std::lower_bound(first, last, c);
+  return it != last && *it == c ? values_[it - col_idx_.begin()] : value_type(0);
+}
+
+
+// matrix-vector product A*x
+dense_vector operator*(sparse_matrix const& A, dense_vector const& x)
+{
+  using value_type = typename sparse_matrix::value_type;
+  dense_vector y(A.rows(), value_type(0));
+  A.mult(x, y);
+  return y;
+}
+
+
+// computes the matrix-vector product, y = Ax.
+void sparse_matrix::mult(dense_vector const& x, dense_vector& y) const
+{
+  sparse_mult_add(*this, x, static_cast<dense_vector const*>(nullptr), y);
+}
+
+
+// computes v3 = v2 + A * v1.
+void sparse_matrix::mult_add(dense_vector const& v1, dense_vector const& v2, dense_vector& v3) const
+{
+  sparse_mult_add(*this, v1, &v2, v3);
+}
+
+
+// computes the matrix-vector product, y = Ax, for vector views
+void sparse_matrix::mult(const_vector_view const& x, vector_view const& y) const
+{
+  sparse_mult_add(*this, x, static_cast<const_vector_view const*>(nullptr), y);
+}
+
+
+// computes v3 = v2 + A * v1 for vector views
+void sparse_matrix::mult_add(const_vector_view const& v1, const_vector_view const& v2, vector_view const& v3) const
+{
+  sparse_mult_add(*this, v1, &v2, v3);
+}
+
+
+// Setup a sparse matrix according to a Laplacian equation on a 2D-grid using a five-point-stencil.
+void laplacian_setup(sparse_matrix& A, std::size_t m, std::size_t n)
+{
+  stencil_setup<2>(A, {m, n}, unit_coefficient{});
+}
+
+
+// Setup a sparse matrix according to a Laplacian equation on a 3D-grid using a seven-point-stencil.
+void laplacian_setup(sparse_matrix& A, std::size_t m, std::size_t n, std::size_t p)
+{
+  stencil_setup<3>(A, {m, n, p}, unit_coefficient{});
+}
+
+
+// Setup a sparse matrix according to the diffusion equation -div(k grad u) = f on a 2D-grid
+void diffusion_setup(sparse_matrix& A, dense_vector const& k, std::size_t m, std::size_t n)
+{
+  assert(k.size() == m*n);
+  stencil_setup<2>(A, {m, n}, harmonic_coefficient{k});
+}
+
+
+// Setup a sparse matrix according to the diffusion equation -div(k grad u) = f on a 3D-grid
+void diffusion_setup(sparse_matrix& A, dense_vector const& k, std::size_t m, std::size_t n, std::size_t p)
+{
+  assert(k.size() == m*n*p);
+  stencil_setup<3>(A, {m, n, p}, harmonic_coefficient{k});
+}
+
+} // end namespace scprog
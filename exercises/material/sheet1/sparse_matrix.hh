@@ -0,0 +1,135 @@
+#ifndef SCPROG_SPARSE_MATRIX_HH
+#define SCPROG_SPARSE_MATRIX_HH
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "allocator.hh"
+#include "linear_algebra.hh"
+
+namespace scprog
+{
+  /// A sparse matrix in compressed row storage (CRS), i.e. the nonzeros of row r are stored
+  /// with ascending column indices in the positions row_ptr[r],...,row_ptr[r+1]-1 of the
+  /// column index and value arrays.
+  class sparse_matrix
+  {
+  public:
+    using size_type       = std::size_t;
+    using value_type      = double;
+
+    /// storage of the compressed row arrays, left uninitialized on allocation such that the
+    /// setup can first-touch the memory in parallel
+    template <class T>
+    using array_type = std::vector<T, first_touch_allocator<T>>;
+
+
+  // ----- constructors / assignment -------------------------------------------
+  public:
+
+    /// default constructor, creates an empty matrix of size 0x0
+    sparse_matrix() = default;
+
+    /// constructor of a matrix with rows r and columns c from the compressed row arrays
+    sparse_matrix(size_type r, size_type c, array_type<size_type> row_ptr,
+                  array_type<size_type> col_idx, array_type<value_type> values)
+      : row_ptr_(std::move(row_ptr))
+      , col_idx_(std::move(col_idx))
+      , values_(std::move(values))
+      , rows_(r)
+      , cols_(c)
+    {
+      assert(row_ptr_.size() == r+1);
+      assert(col_idx_.size() == row_ptr_[r]);
+      assert(values_.size() == row_ptr_[r]);
+    }
+
+    /// return the number of rows in the matrix
+    size_type rows() const
+    {
+      return rows_;
+    }
+
+    /// return the number of columns in the matrix
+    size_type cols() const
+    {
+      return cols_;
+    }
+
+    /// return the number of stored nonzeros
+    size_type nnz() const
+    {
+      return values_.size();
+    }
+
+
+  // ----- element access functions  -------------------------------------------
+  public:
+
+    /// offsets of the rows into the column index and value arrays, of size rows()+1
+    array_type<size_type> const& row_ptr() const { return row_ptr_; }
+
+    /// column indices of the nonzeros
+    array_type<size_type> const& col_idx() const { return col_idx_; }
+
+    /// values of the nonzeros
+    array_type<value_type> const& values() const { return values_; }
+
+    /// return the (r,c)-th matrix element, zero if it is not stored
+    value_type operator()(size_type r, size_type c) const;
+
+
+  // ----- binary operations  ---------------------------------------------------
+  public:
+
+    /// matrix vector product A*x
+    friend dense_vector operator*(sparse_matrix const& A, dense_vector const& x);
+
+    /// computes the matrix-vector product, y = Ax.
+    void mult(dense_vector const& x, dense_vector& y) const;
+
+    /// computes v3 = v2 + A * v1.
+    void mult_add(dense_vector const& v1, dense_vector const& v2, dense_vector& v3) const;
+
+    /// computes the matrix-vector product, y = Ax, for views on vector entries (see views.hh),
+    /// e.g. parts of larger vectors. x and y must not overlap.
+    void mult(basic_vector_view<value_type const> const& x, basic_vector_view<value_type> const& y) const;
+
+    /// computes v3 = v2 + A * v1 for views on vector entries. v1 and v3 must not overlap.
+    void mult_add(basic_vector_view<value_type const> const& v1, basic_vector_view<value_type const> const& v2,
+                  basic_vector_view<value_type> const& v3) const;
+
+
+  // ----- data members  -------------------------------------------------------
+  private:
+
+    array_type<size_type> row_ptr_;
+    array_type<size_type> col_idx_;
+    array_type<value_type> values_;
+    size_type rows_ = 0;
+    size_type cols_ = 0;
+  };
+
+
+  /// Setup a sparse matrix according to a Laplacian equation on a 2D-grid using a five-point-stencil.
+  /// Results in a matrix A of size (m*n) x (m*n) with the same entries as the dense variant
+  void laplacian_setup(sparse_matrix& A, std::size_t m, std::size_t n);
+
+  /// Setup a sparse matrix according to a Laplacian equation on a 3D-grid using a seven-point-stencil.
+  /// Results in a matrix A of size (m*n*p) x (m*n*p), with grid point (i,j,l) numbered (i*n + j)*p + l
+  void laplacian_setup(sparse_matrix& A, std::size_t m, std::size_t n, std::size_t p);
+
+  /// Setup a sparse matrix according to the diffusion equation -div(k grad u) = f on a 2D-grid
+  /// with homogeneous Dirichlet boundary, using the five-point-stencil with the coefficient k
+  /// given per grid point (vector of size m*n). The coefficient on the face between two grid
+  /// points is the harmonic mean of their values, thus k = 1 reproduces \ref laplacian_setup.
+  void diffusion_setup(sparse_matrix& A, dense_vector const& k, std::size_t m, std::size_t n);
+
+  /// Setup a sparse matrix according to the diffusion equation -div(k grad u) = f on a 3D-grid
+  /// using the seven-point-stencil, with the coefficient k given per grid point (vector of size m*n*p)
+  void diffusion_setup(sparse_matrix& A, dense_vector const& k, std::size_t m, std::size_t n, std::size_t p);
+
+} // end namespace scprog
+
+#endif // SCPROG_SPARSE_MATRIX_HH
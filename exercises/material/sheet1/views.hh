@@ -0,0 +1,547 @@
+#ifndef SCPROG_VIEWS_HH
+#define SCPROG_VIEWS_HH
+
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+
+#include "linear_algebra.hh"
+#include "reduction.hh"
+
+namespace scprog
+{
+  /// A non-owning view on size() entries in memory with constant distance stride(), e.g. a
+  /// part of a dense_vector or a row or column of a dense_matrix. The view provides the
+  /// vector-space operations of dense_vector, acting in-place on the viewed entries.
+  /// Copy construction copies the reference, while assignment copies the entries like
+  /// \ref assign, so a view is never rebound.
+  /**
+   * \tparam T  The entry type, `double` for mutable and `double const` for read-only views.
+   **/
+  template <class T>
+  class basic_vector_view
+  {
+  public:
+    using size_type       = std::size_t;
+    using value_type      = std::remove_const_t<T>;
+    using reference       = T&;
+    using const_reference = value_type const&;
+    using pointer         = T*;
+
+
+  // ----- constructors / assignment -------------------------------------------
+  public:
+
+    /// default constructor, creates an empty view
+    basic_vector_view() = default;
+
+    /// constructor of a view on the entries data[i*stride], i < size
+    basic_vector_view(pointer data, size_type size, size_type stride = 1)
+      : data_(data)
+      , size_(size)
+      , stride_(stride)
+    {}
+
+    /// constructor of a view on all entries of a vector
+    explicit basic_vector_view(dense_vector& v)
+      : basic_vector_view(v.data(), v.size())
+    {}
+
+    /// constructor of a read-only view on all entries of a constant vector
+    template <class U = T,
+      std::enable_if_t<std::is_const<U>::value, int> = 0>
+    explicit basic_vector_view(dense_vector const& v)
+      : basic_vector_view(v.data(), v.size())
+    {}
+
+    /// conversion of a mutable view into a read-only view
+    template <class U,
+      std::enable_if_t<std::is_same<T, U const>::value, int> = 0>
+    basic_vector_view(basic_vector_view<U> const& that)
+      : basic_vector_view(that.data(), that.size(), that.stride())
+    {}
+
+    /// copy constructor, creates a view on the same entries
+    basic_vector_view(basic_vector_view const&) = default;
+
+    /// copy the entries of that into the viewed entries, see \ref assign
+    basic_vector_view const& operator=(basic_vector_view const& that) const
+    {
+      assign(that);
+      return *this;
+    }
+
+    /// copy the entries of a view with the same value type into the viewed entries
+    template <class U,
+      std::enable_if_t<std::is_same<std::remove_const_t<U>, value_type>::value, int> = 0>
+    basic_vector_view const& operator=(basic_vector_view<U> const& that) const
+    {
+      assign(that);
+      return *this;
+    }
+
+    /// copy the entries of the vector v into the viewed entries
+    basic_vector_view const& operator=(dense_vector const& v) const
+    {
+      assign(basic_vector_view<value_type const>(v));
+      return *this;
+    }
+
+    /// set all viewed entries to value v
+    basic_vector_view const& operator=(value_type v) const
+    {
+      static_assert(!std::is_const<T>::value, "cannot assign to a read-only view");
+      for (size_type i = 0; i < size_; ++i)
+        (*this)[i] = v;
+      return *this;
+    }
+
+    /// copy the entries of that into the viewed entries
+    void assign(basic_vector_view<value_type const> const& that) const
+    {
+      static_assert(!std::is_const<T>::value, "cannot assign to a read-only view");
+      assert(size() == that.size());
+      for (size_type i = 0; i < size_; ++i)
+        (*this)[i] = that[i];
+    }
+
+    /// return the number of viewed entries
+    size_type size() const
+    {
+      return size_;
+    }
+
+    /// return the distance of consecutive entries in memory
+    size_type stride() const
+    {
+      return stride_;
+    }
+
+    /// return a pointer to the first viewed entry
+    pointer data() const
+    {
+      return data_;
+    }
+
+
+  // ----- element access functions  -------------------------------------------
+  public:
+
+    /// return a reference to the i-th viewed entry
+    reference operator[](size_type i) const
+    {
+      assert(i < size_);
+      return data_[i * stride_];
+    }
+
+    /// return a view on count entries starting at first, with additional stride
+    basic_vector_view sub(size_type first, size_type count, size_type stride = 1) const
+    {
+      assert(count == 0 || first + (count-1)*stride < size_);
+      return {data_ + first * stride_, count, stride * stride_};
+    }
+
+
+  // ----- vector-space operations  --------------------------------------------
+  public:
+
+    /// perform update-assignment elementwise +=
+    basic_vector_view const& operator+=(basic_vector_view<value_type const> const& that) const
+    {
+      assert(size() == that.size());
+      for (size_type i = 0; i < size_; ++i)
+        (*this)[i] += that[i];
+      return *this;
+    }
+
+    /// perform update-assignment elementwise -=
+    basic_vector_view const& operator-=(basic_vector_view<value_type const> const& that) const
+    {
+      assert(size() == that.size());
+      for (size_type i = 0; i < size_; ++i)
+        (*this)[i] -= that[i];
+      return *this;
+    }
+
+    /// perform update-assignment elementwise *= with a scalar
+    basic_vector_view const& operator*=(value_type s) const
+    {
+      for (size_type i = 0; i < size_; ++i)
+        (*this)[i] *= s;
+      return *this;
+    }
+
+    /// perform update-assignment elementwise /= with a scalar
+    basic_vector_view const& operator/=(value_type s) const
+    {
+      assert(s != value_type(0));
+      for (size_type i = 0; i < size_; ++i)
+        (*this)[i] /= s;
+      return *this;
+    }
+
+    /// computes Y = a*X + Y.
+    void axpy(value_type a, basic_vector_view<value_type const> const& X) const
+    {
+      assert(size() == X.size());
+      for (size_type i = 0; i < size_; ++i)
+        (*this)[i] += a * X[i];
+    }
+
+    /// computes Y = a*Y + X.
+    void aypx(value_type a, basic_vector_view<value_type const> const& X) const
+    {
+      assert(size() == X.size());
+      for (size_type i = 0; i < size_; ++i)
+        (*this)[i] = a * (*this)[i] + X[i];
+    }
+
+
+  // ----- reduction operators  ------------------------------------------------
+  public:
+
+    /// return the two-norm ||vector||_2 = sqrt(sum_i v_i^2)
+    value_type two_norm() const
+    {
+      using std::sqrt;
+      return sqrt(unary_dot());
+    }
+
+    /// return the infinity-norm ||vector||_inf = max_i(|v_i|)
+    value_type inf_norm() const
+    {
+      using std::abs;
+      using std::max;
+      value_type result = 0;
+      for (size_type i = 0; i < size_; ++i)
+        result = max(result, value_type(abs((*this)[i])));
+      return result;
+    }
+
+    /// return v^T*v
+    value_type unary_dot() const
+    {
+      T* v = data_;
+      size_type const s = stride_;
+      return reduce_sum(size_, [v,s](size_type i) { return v[i*s] * v[i*s]; });
+    }
+
+    /// return v^T*v2
+    value_type dot(basic_vector_view<value_type const> const& v2) const
+    {
+      assert(size() == v2.size());
+      T* v = data_;
+      value_type const* w = v2.data();
+      size_type const s = stride_, t = v2.stride();
+      return reduce_sum(size_, [v,w,s,t](size_type i) { return v[i*s] * w[i*t]; });
+    }
+
+
+  // ----- data members  -------------------------------------------------------
+  private:
+
+    pointer data_ = nullptr;
+    size_type size_ = 0;
+    size_type stride_ = 1;
+  };
+
+  /// A mutable view on vector entries
+  using vector_view = basic_vector_view<double>;
+
+  /// A read-only view on vector entries
+  using const_vector_view = basic_vector_view<double const>;
+
+
+  /// A non-owning view on a rows() x cols() block of a row-wise stored matrix, with
+  /// distance ld() in memory between the beginning of consecutive rows, e.g. a sub-block of
+  /// a dense_matrix. Rows and columns of the block are accessible as vector views. As for
+  /// vector views, copy construction copies the reference and assignment copies the entries.
+  /**
+   * \tparam T  The entry type, `double` for mutable and `double const` for read-only views.
+   **/
+  template <class T>
+  class basic_matrix_view
+  {
+  public:
+    using size_type       = std::size_t;
+    using value_type      = std::remove_const_t<T>;
+    using reference       = T&;
+    using pointer         = T*;
+
+
+  // ----- constructors / assignment -------------------------------------------
+  public:
+
+    /// default constructor, creates an empty view
+    basic_matrix_view() = default;
+
+    /// constructor of a view on the entries data[r*ld + c], r < rows, c < cols
+    basic_matrix_view(pointer data, size_type rows, size_type cols, size_type ld)
+      : data_(data)
+      , rows_(rows)
+      , cols_(cols)
+      , ld_(ld)
+    {
+      assert(rows == 0 || ld >= cols);
+    }
+
+    /// constructor of a view on all entries of a matrix
+    explicit basic_matrix_view(dense_matrix& A)
+      : basic_matrix_view(A.data(), A.rows(), A.cols(), A.cols())
+    {}
+
+    /// constructor of a read-only view on all entries of a constant matrix
+    template <class U = T,
+      std::enable_if_t<std::is_const<U>::value, int> = 0>
+    explicit basic_matrix_view(dense_matrix const& A)
+      : basic_matrix_view(A.data(), A.rows(), A.cols(), A.cols())
+    {}
+
+    /// conversion of a mutable view into a read-only view
+    template <class U,
+      std::enable_if_t<std::is_same<T, U const>::value, int> = 0>
+    basic_matrix_view(basic_matrix_view<U> const& that)
+      : basic_matrix_view(that.data(), that.rows(), that.cols(), that.ld())
+    {}
+
+    /// copy constructor, creates a view on the same entries
+    basic_matrix_view(basic_matrix_view const&) = default;
+
+    /// copy the entries of that into the viewed entries, see \ref assign
+    basic_matrix_view const& operator=(basic_matrix_view const& that) const
+    {
+      assign(that);
+      return *this;
+    }
+
+    /// copy the entries of a view with the same value type into the viewed entries
+    template <class U,
+      std::enable_if_t<std::is_same<std::remove_const_t<U>, value_type>::value, int> = 0>
+    basic_matrix_view const& operator=(basic_matrix_view<U> const& that) const
+    {
+      assign(that);
+      return *this;
+    }
+
+    /// copy the entries of the matrix A into the viewed entries
+    basic_matrix_view const& operator=(dense_matrix const& A) const
+    {
+      assign(basic_matrix_view<value_type const>(A));
+      return *this;
+    }
+
+    /// set all viewed entries to value v
+    basic_matrix_view const& operator=(value_type v) const
+    {
+      for (size_type r = 0; r < rows_; ++r)
+        row(r) = v;
+      return *this;
+    }
+
+    /// copy the entries of that into the viewed entries
+    void assign(basic_matrix_view<value_type const> const& that) const
+    {
+      assert(rows() == that.rows() && cols() == that.cols());
+      for (size_type r = 0; r < rows_; ++r)
+        row(r).assign(that.row(r));
+    }
+
+    /// return the number of rows in the view
+    size_type rows() const
+    {
+      return rows_;
+    }
+
+    /// return the number of columns in the view
+    size_type cols() const
+    {
+      return cols_;
+    }
+
+    /// return the distance in memory between consecutive rows
+    size_type ld() const
+    {
+      return ld_;
+    }
+
+    /// return a pointer to the (0,0)-th viewed entry
+    pointer data() const
+    {
+      return data_;
+    }
+
+
+  // ----- element access functions  -------------------------------------------
+  public:
+
+    /// access to the (r,c)-th viewed element
+    reference operator()(size_type r, size_type c) const
+    {
+      assert(r < rows_ && c < cols_);
+      return data_[ld_ * r + c];
+    }
+
+    /// return a view on the r-th row
+    basic_vector_view<T> row(size_type r) const
+    {
+      assert(r < rows_);
+      return {data_ + ld_ * r, cols_, 1};
+    }
+
+    /// return a strided view on the c-th column
+    basic_vector_view<T> column(size_type c) const
+    {
+      assert(c < cols_);
+      return {data_ + c, rows_, ld_};
+    }
+
+    /// return a view on the nr x nc block starting at entry (r0,c0)
+    basic_matrix_view block(size_type r0, size_type c0, size_type nr, size_type nc) const
+    {
+      assert(r0 + nr <= rows_ && c0 + nc <= cols_);
+      return {data_ + ld_ * r0 + c0, nr, nc, ld_};
+    }
+
+
+  // ----- binary operations  ---------------------------------------------------
+  public:
+
+    /// perform update-assignment elementwise +=
+    basic_matrix_view const& operator+=(basic_matrix_view<value_type const> const& that) const
+    {
+      assert(rows() == that.rows() && cols() == that.cols());
+      for (size_type r = 0; r < rows_; ++r)
+        row(r) += that.row(r);
+      return *this;
+    }
+
+    /// perform update-assignment elementwise -=
+    basic_matrix_view const& operator-=(basic_matrix_view<value_type const> const& that) const
+    {
+      assert(rows() == that.rows() && cols() == that.cols());
+      for (size_type r = 0; r < rows_; ++r)
+        row(r) -= that.row(r);
+      return *this;
+    }
+
+    /// perform update-assignment elementwise *= with a scalar
+    basic_matrix_view const& operator*=(value_type s) const
+    {
+      for (size_type r = 0; r < rows_; ++r)
+        row(r) *= s;
+      return *this;
+    }
+
+    /// computes Y = a*X + Y.
+    void axpy(value_type a, basic_matrix_view<value_type const> const& X) const
+    {
+      assert(rows() == X.rows() && cols() == X.cols());
+      for (size_type r = 0; r < rows_; ++r)
+        row(r).axpy(a, X.row(r));
+    }
+
+    /// computes Y = a*Y + X.
+    void aypx(value_type a, basic_matrix_view<value_type const> const& X) const
+    {
+      assert(rows() == X.rows() && cols() == X.cols());
+      for (size_type r = 0; r < rows_; ++r)
+        row(r).aypx(a, X.row(r));
+    }
+
+    /// computes the matrix-vector product, y = Ax.
+    void mult(const_vector_view const& x, vector_view const& y) const
+    {
+      assert(x.size() == cols());
+      assert(y.size() == rows());
+      for (size_type r = 0; r < rows_; ++r) {
+        T* row = data_ + ld_ * r;
+        value_type y_r = 0;
+        for (size_type c = 0; c < cols_; ++c)
+          y_r += row[c] * x[c];
+        y[r] = y_r;
+      }
+    }
+
+    /// computes v3 = v2 + A * v1.
+    void mult_add(const_vector_view const& v1, const_vector_view const& v2, vector_view const& v3) const
+    {
+      assert(v1.size() == cols());
+      assert(v2.size() == rows());
+      assert(v3.size() == rows());
+      for (size_type r = 0; r < rows_; ++r) {
+        T* row = data_ + ld_ * r;
+        value_type v3_r = v2[r];
+        for (size_type c = 0; c < cols_; ++c)
+          v3_r += row[c] * v1[c];
+        v3[r] = v3_r;
+      }
+    }
+
+
+  // ----- data members  -------------------------------------------------------
+  private:
+
+    pointer data_ = nullptr;
+    size_type rows_ = 0;
+    size_type cols_ = 0;
+    size_type ld_ = 0;
+  };
+
+  /// A mutable view on matrix entries
+  using matrix_view = basic_matrix_view<double>;
+
+  /// A read-only view on matrix entries
+  using const_matrix_view = basic_matrix_view<double const>;
+
+
+  /// return a view on count entries of v starting at first, with the given stride
+  inline vector_view subvector(dense_vector& v, std::size_t first, std::size_t count, std::size_t stride = 1)
+  {
+    return vector_view(v).sub(first, count, stride);
+  }
+
+  /// return a read-only view on count entries of v starting at first, with the given stride
+  inline const_vector_view subvector(dense_vector const& v, std::size_t first, std::size_t count, std::size_t stride = 1)
+  {
+    return const_vector_view(v).sub(first, count, stride);
+  }
+
+  /// return a view on the r-th row of A
+  inline vector_view row(dense_matrix& A, std::size_t r)
+  {
+    return matrix_view(A).row(r);
+  }
+
+  /// return a read-only view on the r-th row of A
+  inline const_vector_view row(dense_matrix const& A, std::size_t r)
+  {
+    return const_matrix_view(A).row(r);
+  }
+
+  /// return a strided view on the c-th column of A
+  inline vector_view column(dense_matrix& A, std::size_t c)
+  {
+    return matrix_view(A).column(c);
+  }
+
+  /// return a strided read-only view on the c-th column of A
+  inline const_vector_view column(dense_matrix const& A, std::size_t c)
+  {
+    return const_matrix_view(A).column(c);
+  }
+
+  /// return a view on the nr x nc block of A starting at entry (r0,c0)
+  inline matrix_view block(dense_matrix& A, std::size_t r0, std::size_t c0, std::size_t nr, std::size_t nc)
+  {
+    return matrix_view(A).block(r0, c0, nr, nc);
+  }
+
+  /// return a read-only view on the nr x nc block of A starting at entry (r0,c0)
+  inline const_matrix_view block(dense_matrix const& A, std::size_t r0, std::size_t c0, std::size_t nr, std::size_t nc)
+  {
+    return const_matrix_view(A).block(r0, c0, nr, nc);
+  }
+
+} // end namespace scprog
+
+#endif // SCPROG_VIEWS_HH